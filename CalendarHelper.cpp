@@ -2,24 +2,15 @@
 
 void CalendarHelperClass::ParseStrDateTime(sDateTime & pDateTime, char pStrDateTime[])
 {
-    char aux[5];
-
     if ((pStrDateTime[10] == 'T') && ((pStrDateTime[19] == 'Z') || (pStrDateTime[23] == 'Z')))
     {
-        memcpy(aux, pStrDateTime, 4);
-        pDateTime.Year = atoi(aux);
-        memset(aux, 0x00, 5);
-        memcpy(aux, &pStrDateTime[5], 2);
-        pDateTime.Month = atoi(aux);
-        memcpy(aux, &pStrDateTime[8], 2);
-        pDateTime.Day = atoi(aux);
-        memcpy(aux, &pStrDateTime[11], 2);
-        pDateTime.Hour = atoi(aux);
-        memcpy(aux, &pStrDateTime[14], 2);
-        pDateTime.Minute = atoi(aux);
-        memcpy(aux, &pStrDateTime[17], 2);
-        pDateTime.Second = atoi(aux);
-        pDateTime.DayOfWeek = GetDayOfWeek(pDateTime.Year, pDateTime.Month, pDateTime.Day);
+        pDateTime.Year = parseNumber(pStrDateTime, 4);
+        pDateTime.Month = parseNumber(&pStrDateTime[5], 2);
+        pDateTime.Day = parseNumber(&pStrDateTime[8], 2);
+        pDateTime.Hour = parseNumber(&pStrDateTime[11], 2);
+        pDateTime.Minute = parseNumber(&pStrDateTime[14], 2);
+        pDateTime.Second = parseNumber(&pStrDateTime[17], 2);
+        pDateTime.DayOfWeek = GetDayOfWeek(pDateTime.Year, pDateTime.Month, pDateTime.Day) + 1;
     }
 }
 
@@ -90,14 +81,14 @@ void CalendarHelperClass::ConvertToDateTime(sDateTime & pDateTime, uint32_t pSec
     time /= 60; // now it is hours
     pDateTime.Hour = time % 24;
     time /= 24; // now it is days
-    pDateTime.DayOfWeek = ((time + 4) % 7) + 1;  // Sunday is day 1 
+    pDateTime.DayOfWeek = ((time + 6) % 7) + 1;  // Sunday is day 1, Jan 1st of 2000 was a saturday
 
     Year = 0;
     days = 0;
     for (;;)
     {
         days += (LEAP_YEAR(Year) ? 366 : 365);
-        if (days < time)
+        if (days <= time)
             Year++;
         else
             break;
@@ -178,7 +169,11 @@ void CalendarHelperClass::BeginningOfSummerTime(sDateTime & pDateTime, uint16_t
     // Beginning of the summer time is on November's first sunday
     pDateTime.Year = pYear;
     pDateTime.Month = 11;
-    pDateTime.Day = 8 - CalendarHelperClass::GetDayOfWeek(pYear, 11, 1); // sum 8 because dow starts at 0 and days at 1
+    pDateTime.Day = 1 + (7 - CalendarHelperClass::GetDayOfWeek(pYear, 11, 1)) % 7;
+    pDateTime.DayOfWeek = 1;
+    pDateTime.Hour = 0;
+    pDateTime.Minute = 0;
+    pDateTime.Second = 0;
 }
 
 void CalendarHelperClass::EndingOfSummerTime(sDateTime & pDateTime, uint16_t pYear)
@@ -190,9 +185,13 @@ void CalendarHelperClass::EndingOfSummerTime(sDateTime & pDateTime, uint16_t pYe
     // Sets the third february sunday
     pDateTime.Year = pYear;
     pDateTime.Month = 2;
-    pDateTime.Day = 14 + ((7 - CalendarHelperClass::GetDayOfWeek(pYear, 2, 15)) % 7);
+    pDateTime.Day = 15 + ((7 - CalendarHelperClass::GetDayOfWeek(pYear, 2, 15)) % 7);
+    pDateTime.DayOfWeek = 1;
+    pDateTime.Hour = 0;
+    pDateTime.Minute = 0;
+    pDateTime.Second = 0;
 
-    if (carnavalSunday.Day == pDateTime.Day)
+    if ((carnavalSunday.Month == pDateTime.Month) && (carnavalSunday.Day == pDateTime.Day))
         pDateTime.Day += 7;
 }
 
@@ -212,8 +211,51 @@ uint32_t CalendarHelperClass::Difference(sDateTime & pDateTimeOne, sDateTime & p
 
 void CalendarHelperClass::SPrintTime(char * pBuffer, sDateTime & pDateTime)
 {
-    sprintf(pBuffer, "%i-%i-%i %i:%i:%i",
-        pDateTime.Year, pDateTime.Month, pDateTime.Day, 
-        pDateTime.Hour, pDateTime.Minute, pDateTime.Second);
+    // Same output as "%i-%i-%i %i:%i:%i" without pulling sprintf in
+    pBuffer = SPrintNumber(pBuffer, pDateTime.Year);
+    *pBuffer++ = '-';
+    pBuffer = SPrintNumber(pBuffer, pDateTime.Month);
+    *pBuffer++ = '-';
+    pBuffer = SPrintNumber(pBuffer, pDateTime.Day);
+    *pBuffer++ = ' ';
+    pBuffer = SPrintNumber(pBuffer, pDateTime.Hour);
+    *pBuffer++ = ':';
+    pBuffer = SPrintNumber(pBuffer, pDateTime.Minute);
+    *pBuffer++ = ':';
+    pBuffer = SPrintNumber(pBuffer, pDateTime.Second);
+    *pBuffer = 0;
+}
+
+char * CalendarHelperClass::SPrintNumber(char * pBuffer, uint16_t pNumber)
+{
+    char digits[5];
+    uint8_t length = 0;
+
+    do
+    {
+        digits[length++] = '0' + (pNumber % 10);
+        pNumber /= 10;
+    } while (pNumber);
+
+    while (length)
+    {
+        *pBuffer++ = digits[--length];
+    }
+
+    *pBuffer = 0;
+
+    return pBuffer;
+}
+
+uint16_t CalendarHelperClass::parseNumber(const char * pStr, uint8_t pDigits)
+{
+    uint16_t value = 0;
+
+    while (pDigits-- && (*pStr >= '0') && (*pStr <= '9'))
+    {
+        value = value * 10 + (*pStr++ - '0');
+    }
+
+    return value;
 }
 
@@ -3,7 +3,19 @@
 #ifndef CALENDAR_HELPER
 #define CALENDAR_HELPER
 
+#include "DS3231Config.h"
+
+#if defined(ARDUINO)
 #include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)     (*(const uint8_t *)(addr))
+#endif
 
 #define BASE_YEAR				2000UL
 #define SECS_PER_MIN			60UL
@@ -25,7 +37,7 @@ struct sDateTime
     uint16_t Year;
     uint8_t Month;
     uint8_t Day;
-    uint8_t DayOfWeek;
+    uint8_t DayOfWeek; // Sunday == 1, as counted by the RTC
     uint8_t Hour;
     uint8_t Minute;
     uint8_t Second;
@@ -35,6 +47,7 @@ class CalendarHelperClass
 {
 private:
     static void CarnavalSunday(sDateTime & pDateTime, uint16_t pYear);  // Return the Carnaval day from the given year
+    static uint16_t parseNumber(const char * pStr, uint8_t pDigits); // Parse up to pDigits decimal digits
 
 public:
     static void ParseStrDateTime(sDateTime & pDateTime, char pStrDateTime[]); // Parse from ISO 8601 string format to sDateTime
@@ -47,6 +60,7 @@ public:
     static void EndingOfSummerTime(sDateTime & pDateTime, uint16_t pYear);
     static uint32_t Difference(sDateTime & pDateTimeOne, sDateTime & pDateTimeTwo);
     static void SPrintTime(char * pBuffer, sDateTime & pDateTime);
+    static char * SPrintNumber(char * pBuffer, uint16_t pNumber); // Print pNumber in decimal, returns the end of the string
 };
 
 #endif
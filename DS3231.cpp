@@ -20,389 +20,222 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "DS3231.h"
 
-bool DS3231Class::Begin(void)
+static uint8_t bcd2dec(uint8_t bcd)
 {
-    Wire.begin();
+    return ((bcd / 16) * 10) + (bcd % 16);
+}
 
-    SetBattery(true, false);
+static uint8_t dec2bcd(uint8_t dec)
+{
+    return ((dec / 10) * 16) + (dec % 10);
+}
 
-    return true;
+static void writeRegister8(uint8_t reg, uint8_t value)
+{
+    DS3231Registers::Write(reg, &value, 1);
 }
 
-void DS3231Class::SetDateTime(sDateTime & pDateTime)
+static uint8_t readRegister8(uint8_t reg)
 {
-    Wire.beginTransmission(DS3231_ADDRESS);
+    uint8_t value;
 
-    WireWrite(DS3231_REG_TIME);
+    DS3231Registers::Read(reg, &value, 1);
 
-    WireWrite(dec2bcd(pDateTime.Second));
-    WireWrite(dec2bcd(pDateTime.Minute));
-    WireWrite(dec2bcd(pDateTime.Hour));
-    WireWrite(dec2bcd(CalendarHelperClass::GetDayOfWeek(pDateTime.Year, pDateTime.Month, pDateTime.Day))); // 0 is sunday
-    WireWrite(dec2bcd(pDateTime.Day));
-    WireWrite(dec2bcd(pDateTime.Month));
-    WireWrite(dec2bcd(pDateTime.Year - 2000));
+    return value;
+}
 
-    WireWrite(DS3231_REG_TIME);
+static bool writeRegisters(uint8_t reg, const uint8_t * values, uint8_t length)
+{
+    return DS3231Registers::Write(reg, values, length);
+}
 
-    Wire.endTransmission();
+static bool readRegisters(uint8_t reg, uint8_t * values, uint8_t length)
+{
+    return DS3231Registers::Read(reg, values, length);
 }
 
-void DS3231Class::GetDateTime(sDateTime & pDateTime)
+void DS3231TimeClass::SetDateTime(sDateTime & pDateTime)
 {
-    int values[7];
+    uint8_t values[7];
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(DS3231_REG_TIME);
-    Wire.endTransmission();
+    values[0] = dec2bcd(pDateTime.Second);
+    values[1] = dec2bcd(pDateTime.Minute);
+    values[2] = dec2bcd(pDateTime.Hour);
+    values[3] = CalendarHelperClass::GetDayOfWeek(pDateTime.Year, pDateTime.Month, pDateTime.Day) + 1; // The RTC counts 1 to 7, sunday is 1
+    values[4] = dec2bcd(pDateTime.Day);
+    values[5] = dec2bcd(pDateTime.Month);
+    values[6] = dec2bcd(pDateTime.Year - 2000);
 
-    Wire.requestFrom(DS3231_ADDRESS, 7);
+    writeRegisters(DS3231_REG_TIME, values, 7);
+}
 
-    while (!Wire.available()) {};
+void DS3231TimeClass::GetDateTime(sDateTime & pDateTime)
+{
+    uint8_t values[7];
 
-    for (uint8_t i = 0; i < 7; i++)
-    {
-        values[i] = bcd2dec(WireRead());
-    }
+    readRegisters(DS3231_REG_TIME, values, 7);
 
-    Wire.endTransmission();
+    DecodeDateTime(pDateTime, values);
+}
 
-    pDateTime.Second = values[0];
-    pDateTime.Minute = values[1];
-    pDateTime.Hour = values[2];
-    pDateTime.DayOfWeek = values[3];
-    pDateTime.Day = values[4];
-    pDateTime.Month = values[5];
-    pDateTime.Year = values[6] + 2000;
+void DS3231TimeClass::DecodeDateTime(sDateTime & pDateTime, const uint8_t * pValues)
+{
+    pDateTime.Second = bcd2dec(pValues[0] & ~DS1307_CLOCK_HALT); // Always 0 on the DS323x
+    pDateTime.Minute = bcd2dec(pValues[1]);
+    pDateTime.Hour = bcd2dec(pValues[2]);
+    pDateTime.DayOfWeek = bcd2dec(pValues[3]);
+    pDateTime.Day = bcd2dec(pValues[4]);
+    pDateTime.Month = bcd2dec(pValues[5]);
+    pDateTime.Year = bcd2dec(pValues[6]) + 2000;
 }
 
-void DS3231Class::GetAlarm1(sAlarmTime & pAlarmTime)
+void DS3231ControlClass::GetAlarm1(sAlarmTime & pAlarmTime)
 {
     uint8_t values[4];
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(DS3231_REG_ALARM_1);
-    Wire.endTransmission();
-
-    Wire.requestFrom(DS3231_ADDRESS, 4);
-
-    while (!Wire.available()) {};
+    readRegisters(DS3231_REG_ALARM_1, values, 4);
 
-    for (int i = 3; i >= 0; i--)
-    {
-        values[i] = bcd2dec(WireRead() & 0b01111111);
-    }
-
-    Wire.endTransmission();
-
-    pAlarmTime.Day = values[0];
-    pAlarmTime.Hour = values[1];
-    pAlarmTime.Minute = values[2];
-    pAlarmTime.Second = values[3];
+    DS3231AlarmCodec<1>::DecodeTime(pAlarmTime, values);
 }
 
-void DS3231Class::GetAlarmType1(eDS3231_alarm1_t & pDS3231_alarm1_t)
+void DS3231ControlClass::GetAlarmType1(eDS3231_alarm1_t & pDS3231_alarm1_t)
 {
     uint8_t values[4];
-    uint8_t mode = 0;
-
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(DS3231_REG_ALARM_1);
-    Wire.endTransmission();
-
-    Wire.requestFrom(DS3231_ADDRESS, 4);
-
-    while (!Wire.available()) {};
-
-    for (int i = 3; i >= 0; i--)
-    {
-        values[i] = bcd2dec(WireRead());
-    }
-
-    Wire.endTransmission();
 
-    mode |= ((values[3] & 0b01000000) >> 6);
-    mode |= ((values[2] & 0b01000000) >> 5);
-    mode |= ((values[1] & 0b01000000) >> 4);
-    mode |= ((values[0] & 0b01000000) >> 3);
-    mode |= ((values[0] & 0b00100000) >> 1);
+    readRegisters(DS3231_REG_ALARM_1, values, 4);
 
-    pDS3231_alarm1_t = (eDS3231_alarm1_t)mode;
+    pDS3231_alarm1_t = DS3231AlarmCodec<1>::DecodeMode(values);
 }
 
-void DS3231Class::SetAlarm1(uint8_t dydw, uint8_t Hour, uint8_t Minute, uint8_t Second, eDS3231_alarm1_t mode, bool armed)
+void DS3231ControlClass::SetAlarm1(uint8_t dydw, uint8_t Hour, uint8_t Minute, uint8_t Second, eDS3231_alarm1_t mode, bool armed)
 {
-    Second = dec2bcd(Second);
-    Minute = dec2bcd(Minute);
-    Hour = dec2bcd(Hour);
-    dydw = dec2bcd(dydw);
-
-    switch (mode)
-    {
-    case DS3231_EVERY_SECOND:
-        Second |= 0b10000000;
-        Minute |= 0b10000000;
-        Hour |= 0b10000000;
-        dydw |= 0b10000000;
-        break;
-
-    case DS3231_MATCH_S:
-        Second &= 0b01111111;
-        Minute |= 0b10000000;
-        Hour |= 0b10000000;
-        dydw |= 0b10000000;
-        break;
-
-    case DS3231_MATCH_M_S:
-        Second &= 0b01111111;
-        Minute &= 0b01111111;
-        Hour |= 0b10000000;
-        dydw |= 0b10000000;
-        break;
-
-    case DS3231_MATCH_H_M_S:
-        Second &= 0b01111111;
-        Minute &= 0b01111111;
-        Hour &= 0b01111111;
-        dydw |= 0b10000000;
-        break;
-
-    case DS3231_MATCH_DT_H_M_S:
-        Second &= 0b01111111;
-        Minute &= 0b01111111;
-        Hour &= 0b01111111;
-        dydw &= 0b01111111;
-        break;
-
-    case DS3231_MATCH_DY_H_M_S:
-        Second &= 0b01111111;
-        Minute &= 0b01111111;
-        Hour &= 0b01111111;
-        dydw &= 0b01111111;
-        dydw |= 0b01000000;
-        break;
-    }
-
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(DS3231_REG_ALARM_1);
-    WireWrite(Second);
-    WireWrite(Minute);
-    WireWrite(Hour);
-    WireWrite(dydw);
-    Wire.endTransmission();
-
-    ArmAlarm1(armed);
-
-    ClearAlarm1();
+    SetAlarm(DS3231AlarmCodec<1>::Make(dydw, Hour, Minute, Second, mode), armed);
 }
 
-bool DS3231Class::IsAlarm1(bool clear)
+bool DS3231ControlClass::IsAlarm1(bool clear)
 {
-    uint8_t alarm;
-
-    alarm = readRegister8(DS3231_REG_STATUS);
-    alarm &= 0b00000001;
-
-    if (alarm && clear)
-    {
-        ClearAlarm1();
-    }
-
-    return alarm;
+    return isAlarm(DS3231AlarmTraits<1>::Flag, clear);
 }
 
-void DS3231Class::ArmAlarm1(bool armed)
+void DS3231ControlClass::ArmAlarm1(bool armed)
 {
-    uint8_t value;
-    value = readRegister8(DS3231_REG_CONTROL);
-
-    if (armed)
-    {
-        value |= 0b00000001;
-    }
-    else
-    {
-        value &= 0b11111110;
-    }
-
-    writeRegister8(DS3231_REG_CONTROL, value);
+    armAlarm(DS3231AlarmTraits<1>::Flag, armed);
 }
 
-bool DS3231Class::IsArmed1(void)
+bool DS3231ControlClass::IsArmed1(void)
 {
-    uint8_t value;
-    value = readRegister8(DS3231_REG_CONTROL);
-    value &= 0b00000001;
-    return value;
+    return isArmed(DS3231AlarmTraits<1>::Flag);
 }
 
-void DS3231Class::ClearAlarm1(void)
+void DS3231ControlClass::ClearAlarm1(void)
 {
-    uint8_t value;
-
-    value = readRegister8(DS3231_REG_STATUS);
-    value &= 0b11111110;
-
-    writeRegister8(DS3231_REG_STATUS, value);
+    clearAlarm(DS3231AlarmTraits<1>::Flag);
 }
 
-void DS3231Class::GetAlarm2(sAlarmTime & pAlarmTime)
+void DS3231ControlClass::GetAlarm2(sAlarmTime & pAlarmTime)
 {
     uint8_t values[3];
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(DS3231_REG_ALARM_2);
-    Wire.endTransmission();
+    readRegisters(DS3231_REG_ALARM_2, values, 3);
 
-    Wire.requestFrom(DS3231_ADDRESS, 3);
-
-    while (!Wire.available()) {};
+    DS3231AlarmCodec<2>::DecodeTime(pAlarmTime, values);
+}
 
-    for (int i = 2; i >= 0; i--)
-    {
-        values[i] = bcd2dec(WireRead() & 0b01111111);
-    }
+void DS3231ControlClass::GetAlarmType2(eDS3231_alarm2_t & pDS3231_alarm2_t)
+{
+    uint8_t values[3];
 
-    Wire.endTransmission();
+    readRegisters(DS3231_REG_ALARM_2, values, 3);
 
-    pAlarmTime.Day = values[0];
-    pAlarmTime.Hour = values[1];
-    pAlarmTime.Minute = values[2];
-    pAlarmTime.Second = 0;
+    pDS3231_alarm2_t = DS3231AlarmCodec<2>::DecodeMode(values);
 }
 
-void DS3231Class::GetAlarmType2(eDS3231_alarm2_t & pDS3231_alarm2_t)
+void DS3231ControlClass::SetAlarm2(uint8_t dydw, uint8_t Hour, uint8_t Minute, eDS3231_alarm2_t mode, bool armed)
 {
-    uint8_t values[3];
-    uint8_t mode = 0;
+    SetAlarm(DS3231AlarmCodec<2>::Make(dydw, Hour, Minute, 0, mode), armed);
+}
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(DS3231_REG_ALARM_2);
-    Wire.endTransmission();
+void DS3231ControlClass::ArmAlarm2(bool armed)
+{
+    armAlarm(DS3231AlarmTraits<2>::Flag, armed);
+}
 
-    Wire.requestFrom(DS3231_ADDRESS, 3);
+bool DS3231ControlClass::IsArmed2(void)
+{
+    return isArmed(DS3231AlarmTraits<2>::Flag);
+}
 
-    while (!Wire.available()) {};
+void DS3231ControlClass::ClearAlarm2(void)
+{
+    clearAlarm(DS3231AlarmTraits<2>::Flag);
+}
 
-    for (int i = 2; i >= 0; i--)
-    {
-        values[i] = bcd2dec(WireRead());
-    }
+bool DS3231ControlClass::IsAlarm2(bool clear)
+{
+    return isAlarm(DS3231AlarmTraits<2>::Flag, clear);
+}
 
-    Wire.endTransmission();
+void DS3231ControlClass::setAlarm(uint8_t reg, const uint8_t * values, uint8_t size, uint8_t flag, bool armed)
+{
+    // Clear first, a match between the write and a later clear would be lost
+    clearAlarm(flag);
 
-    mode |= ((values[2] & 0b01000000) >> 5);
-    mode |= ((values[1] & 0b01000000) >> 4);
-    mode |= ((values[0] & 0b01000000) >> 3);
-    mode |= ((values[0] & 0b00100000) >> 1);
+    writeRegisters(reg, values, size);
 
-    pDS3231_alarm2_t = (eDS3231_alarm2_t)mode;
+    armAlarm(flag, armed);
 }
 
-void DS3231Class::SetAlarm2(uint8_t dydw, uint8_t Hour, uint8_t Minute, eDS3231_alarm2_t mode, bool armed)
+bool DS3231ControlClass::isAlarm(uint8_t flag, bool clear)
 {
-    Minute = dec2bcd(Minute);
-    Hour = dec2bcd(Hour);
-    dydw = dec2bcd(dydw);
+    uint8_t alarm;
 
-    switch (mode)
+    alarm = readRegister8(DS3231_REG_STATUS);
+    alarm &= flag;
+
+    if (alarm && clear)
     {
-    case DS3231_EVERY_MINUTE:
-        Minute |= 0b10000000;
-        Hour |= 0b10000000;
-        dydw |= 0b10000000;
-        break;
-
-    case DS3231_MATCH_M:
-        Minute &= 0b01111111;
-        Hour |= 0b10000000;
-        dydw |= 0b10000000;
-        break;
-
-    case DS3231_MATCH_H_M:
-        Minute &= 0b01111111;
-        Hour &= 0b01111111;
-        dydw |= 0b10000000;
-        break;
-
-    case DS3231_MATCH_DT_H_M:
-        Minute &= 0b01111111;
-        Hour &= 0b01111111;
-        dydw &= 0b01111111;
-        break;
-
-    case DS3231_MATCH_DY_H_M:
-        Minute &= 0b01111111;
-        Hour &= 0b01111111;
-        dydw &= 0b01111111;
-        dydw |= 0b01000000;
-        break;
+        clearAlarm(flag);
     }
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(DS3231_REG_ALARM_2);
-    WireWrite(Minute);
-    WireWrite(Hour);
-    WireWrite(dydw);
-    Wire.endTransmission();
-
-    ArmAlarm2(armed);
-
-    ClearAlarm2();
+    return alarm;
 }
 
-void DS3231Class::ArmAlarm2(bool armed)
+void DS3231ControlClass::armAlarm(uint8_t flag, bool armed)
 {
     uint8_t value;
     value = readRegister8(DS3231_REG_CONTROL);
 
     if (armed)
     {
-        value |= 0b00000010;
+        value |= flag;
     }
     else
     {
-        value &= 0b11111101;
+        value &= ~flag;
     }
 
     writeRegister8(DS3231_REG_CONTROL, value);
 }
 
-bool DS3231Class::IsArmed2(void)
+bool DS3231ControlClass::isArmed(uint8_t flag)
 {
     uint8_t value;
     value = readRegister8(DS3231_REG_CONTROL);
-    value &= 0b00000010;
-    value >>= 1;
+    value &= flag;
     return value;
 }
 
-void DS3231Class::ClearAlarm2(void)
+void DS3231ControlClass::clearAlarm(uint8_t flag)
 {
     uint8_t value;
 
     value = readRegister8(DS3231_REG_STATUS);
-    value &= 0b11111101;
+    value &= ~flag;
 
     writeRegister8(DS3231_REG_STATUS, value);
 }
 
-bool DS3231Class::IsAlarm2(bool clear)
-{
-    uint8_t alarm;
-
-    alarm = readRegister8(DS3231_REG_STATUS);
-    alarm &= 0b00000010;
-
-    if (alarm && clear)
-    {
-        ClearAlarm2();
-    }
-
-    return alarm;
-}
-
-void DS3231Class::GetOutput(eDS3231_sqw_t &pMode)
+void DS3231RateSelectClass::GetOutput(eDS3231_sqw_t &pMode)
 {
     uint8_t value;
 
@@ -414,7 +247,7 @@ void DS3231Class::GetOutput(eDS3231_sqw_t &pMode)
     pMode = (eDS3231_sqw_t)value;
 }
 
-void DS3231Class::SetOutput(eDS3231_sqw_t mode)
+void DS3231RateSelectClass::SetOutput(eDS3231_sqw_t mode)
 {
     uint8_t value;
 
@@ -426,7 +259,7 @@ void DS3231Class::SetOutput(eDS3231_sqw_t mode)
     writeRegister8(DS3231_REG_CONTROL, value);
 }
 
-void DS3231Class::EnableOutput(bool enabled)
+void DS3231ControlClass::EnableOutput(bool enabled)
 {
     uint8_t value;
 
@@ -438,7 +271,7 @@ void DS3231Class::EnableOutput(bool enabled)
     writeRegister8(DS3231_REG_CONTROL, value);
 }
 
-bool DS3231Class::IsOutput(void)
+bool DS3231ControlClass::IsOutput(void)
 {
     uint8_t value;
 
@@ -450,7 +283,7 @@ bool DS3231Class::IsOutput(void)
     return !value;
 }
 
-void DS3231Class::Enable32kHz(bool enabled)
+void DS3231Output32kHzClass::Enable32kHz(bool enabled)
 {
     uint8_t value;
 
@@ -462,7 +295,7 @@ void DS3231Class::Enable32kHz(bool enabled)
     writeRegister8(DS3231_REG_STATUS, value);
 }
 
-bool DS3231Class::Is32kHz(void)
+bool DS3231Output32kHzClass::Is32kHz(void)
 {
     uint8_t value;
 
@@ -474,42 +307,86 @@ bool DS3231Class::Is32kHz(void)
     return value;
 }
 
-void DS3231Class::ForceConversion(void)
+void DS3231ControlClass::ForceConversion(void)
 {
-    uint8_t busy;
-    uint8_t value;
+    // A conversion cannot be started while the automatic one runs
+    do {} while (!StartConversion());
 
-    busy = readRegister8(DS3231_REG_STATUS);
+    do {} while (IsConverting());
+}
 
-    if (busy & 0b00000100)
-    {
-        value = readRegister8(DS3231_REG_CONTROL);
-        value |= 0b00100000;
-        writeRegister8(DS3231_REG_CONTROL, value);
+bool DS3231ControlClass::StartConversion(void)
+{
+    uint8_t value;
 
-        do {} while ((readRegister8(DS3231_REG_CONTROL) & 0b00100000) != 0);
+    if (IsConverting())
+    {
+        return false;
     }
+
+    value = readRegister8(DS3231_REG_CONTROL);
+    value |= DS3231_CONTROL_CONV;
+    writeRegister8(DS3231_REG_CONTROL, value);
+
+    return true;
 }
 
-float DS3231Class::GetTemperature(void)
+bool DS3231ControlClass::IsConverting(void)
 {
-    uint8_t msb, lsb;
+    return ((readRegister8(DS3231_REG_STATUS) & DS3231_STATUS_BSY) != 0) ||
+           ((readRegister8(DS3231_REG_CONTROL) & DS3231_CONTROL_CONV) != 0);
+}
+
+#if !defined(DS3231_NO_FLOAT)
+float DS3231ControlClass::GetTemperature(void)
+{
+    return GetTemperatureRaw() / 4.0f;
+}
+#endif
+
+int16_t DS3231ControlClass::GetTemperatureRaw(void)
+{
+    uint8_t values[2];
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(DS3231_REG_TEMPERATURE);
-    Wire.endTransmission();
+    readRegisters(DS3231_REG_TEMPERATURE, values, 2);
 
-    Wire.requestFrom(DS3231_ADDRESS, 2);
+    return (int16_t)(((uint16_t)values[0] << 8) | values[1]) >> 6;
+}
 
-    while (!Wire.available()) {};
+char * DS3231ControlClass::SPrintTemperature(char * pBuffer, int16_t pTemperature)
+{
+    uint16_t value = pTemperature;
 
-    msb = WireRead();
-    lsb = WireRead();
+    if (pTemperature < 0)
+    {
+        *pBuffer++ = '-';
+        value = -pTemperature;
+    }
 
-    return ((((short)msb << 8) | (short)lsb) >> 6) / 4.0f;
+    pBuffer = CalendarHelperClass::SPrintNumber(pBuffer, value >> 2);
+    *pBuffer++ = '.';
+    pBuffer = CalendarHelperClass::SPrintNumber(pBuffer, (value & 3) * 25);
+
+    if ((value & 3) == 0)
+    {
+        *pBuffer++ = '0';
+        *pBuffer = 0;
+    }
+
+    return pBuffer;
 }
 
-void DS3231Class::SetBattery(bool timeBattery, bool squareBattery)
+void DS3231ControlClass::SetAging(int8_t pAging)
+{
+    writeRegister8(DS3231_REG_AGING, (uint8_t)pAging);
+}
+
+int8_t DS3231ControlClass::GetAging(void)
+{
+    return (int8_t)readRegister8(DS3231_REG_AGING);
+}
+
+void DS3231ControlClass::SetBattery(bool timeBattery, bool squareBattery)
 {
     uint8_t value;
 
@@ -536,36 +413,80 @@ void DS3231Class::SetBattery(bool timeBattery, bool squareBattery)
     writeRegister8(DS3231_REG_CONTROL, value);
 }
 
-uint8_t DS3231Class::bcd2dec(uint8_t bcd)
+uint8_t DS3231ControlClass::GetStatus(void)
 {
-    return ((bcd / 16) * 10) + (bcd % 16);
+    return readRegister8(DS3231_REG_STATUS);
 }
 
-uint8_t DS3231Class::dec2bcd(uint8_t dec)
+bool DS3231ControlClass::IsOscillatorStopped(void)
 {
-    return ((dec / 10) * 16) + (dec % 10);
+    return (readRegister8(DS3231_REG_STATUS) & DS3231_STATUS_OSF) != 0;
+}
+
+void DS3231ControlClass::ClearOscillatorStopped(void)
+{
+    uint8_t value;
+
+    value = readRegister8(DS3231_REG_STATUS);
+    value &= ~DS3231_STATUS_OSF;
+
+    writeRegister8(DS3231_REG_STATUS, value);
 }
 
-void DS3231Class::writeRegister8(uint8_t reg, uint8_t value)
+bool DS1307ClockHaltClass::IsOscillatorStopped(void)
 {
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(reg);
-    WireWrite(value);
-    Wire.endTransmission();
+    return (readRegister8(DS3231_REG_TIME) & DS1307_CLOCK_HALT) != 0;
 }
 
-uint8_t DS3231Class::readRegister8(uint8_t reg)
+void DS1307ClockHaltClass::ClearOscillatorStopped(void)
 {
     uint8_t value;
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    WireWrite(reg);
-    Wire.endTransmission();
+    value = readRegister8(DS3231_REG_TIME);
+    value &= ~DS1307_CLOCK_HALT;
 
-    Wire.requestFrom(DS3231_ADDRESS, 1);
-    while (!Wire.available()) {};
-    value = WireRead();
-    Wire.endTransmission();
+    writeRegister8(DS3231_REG_TIME, value);
+}
 
-    return value;
-}
\ No newline at end of file
+bool DS3231Registers::Read(uint8_t reg, uint8_t * values, uint8_t length)
+{
+    uint8_t chunk;
+
+    while (length)
+    {
+        chunk = (length < DS3231_BUS_MAX_LENGTH) ? length : DS3231_BUS_MAX_LENGTH;
+
+        if (!DS3231Bus.Read(DS3231_ADDRESS, &reg, 1, values, chunk))
+        {
+            return false;
+        }
+
+        reg += chunk;
+        values += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+bool DS3231Registers::Write(uint8_t reg, const uint8_t * values, uint8_t length)
+{
+    uint8_t chunk;
+
+    // The register address takes one byte of the transfer
+    while (length)
+    {
+        chunk = (length < DS3231_BUS_MAX_LENGTH - 1) ? length : DS3231_BUS_MAX_LENGTH - 1;
+
+        if (!DS3231Bus.Write(DS3231_ADDRESS, &reg, 1, values, chunk))
+        {
+            return false;
+        }
+
+        reg += chunk;
+        values += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
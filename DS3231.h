@@ -23,14 +23,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef _DS3231_h
 #define _DS3231_h
 
-#if ARDUINO >= 100
-#include "Arduino.h"
-#else
-#include "WProgram.h"
-#endif
-
+#include "DS3231Bus.h"
 #include "CalendarHelper.h"
-#include <Wire.h>
+#include "DS3231Alarm.h"
+#include "DS3231Device.h"
 
 #define DS3231_ADDRESS              (0x68)
 
@@ -39,15 +35,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define DS3231_REG_ALARM_2          (0x0B)
 #define DS3231_REG_CONTROL          (0x0E)
 #define DS3231_REG_STATUS           (0x0F)
+#define DS3231_REG_AGING            (0x10)
 #define DS3231_REG_TEMPERATURE      (0x11)
 
-struct sAlarmTime
-{
-    uint8_t Day;
-    uint8_t Hour;
-    uint8_t Minute;
-    uint8_t Second;
-};
+#define DS3231_STATUS_OSF           (0b10000000)
+#define DS3231_STATUS_EN32KHZ       (0b00001000)
+#define DS3231_STATUS_BSY           (0b00000100)
+#define DS3231_STATUS_A2F           (0b00000010)
+#define DS3231_STATUS_A1F           (0b00000001)
+
+#define DS3231_CONTROL_CONV         (0b00100000)
+
+#define DS1307_CLOCK_HALT           (0b10000000)
 
 typedef enum
 {
@@ -57,33 +56,28 @@ typedef enum
     DS3231_32768HZ  = 0x03
 } eDS3231_sqw_t;
 
-typedef enum
+// Register access shared by the feature classes. Blocks longer than a bus
+// transfer are split, the register pointer auto-increments.
+class DS3231Registers
 {
-    DS3231_EVERY_SECOND     = 0b00001111,
-    DS3231_MATCH_S          = 0b00001110,
-    DS3231_MATCH_M_S        = 0b00001100,
-    DS3231_MATCH_H_M_S      = 0b00001000,
-    DS3231_MATCH_DT_H_M_S   = 0b00000000,
-    DS3231_MATCH_DY_H_M_S   = 0b00010000
-} eDS3231_alarm1_t;
+public:
+    static bool Read(uint8_t reg, uint8_t * values, uint8_t length);
+    static bool Write(uint8_t reg, const uint8_t * values, uint8_t length);
+};
 
-typedef enum
-{
-    DS3231_EVERY_MINUTE = 0b00001110,
-    DS3231_MATCH_M      = 0b00001100,
-    DS3231_MATCH_H_M    = 0b00001000,
-    DS3231_MATCH_DT_H_M = 0b00000000,
-    DS3231_MATCH_DY_H_M = 0b00010000
-} eDS3231_alarm2_t;
-
-class DS3231Class
+// Time keeping, common to all devices
+class DS3231TimeClass
 {
 public:
-    bool Begin(void);
-
     void SetDateTime(sDateTime & pDateTime); // Set the RTC's module to the given pDateTime
     void GetDateTime(sDateTime & pDateTime); // Get the RTC's module to the given pDateTime
+    static void DecodeDateTime(sDateTime & pDateTime, const uint8_t * pValues); // Decode the 7 time registers
+};
 
+// Control and status registers of the DS3231 family
+class DS3231ControlClass
+{
+public:
     void SetAlarm1(uint8_t dydw, uint8_t Hour, uint8_t Minute, uint8_t Second, eDS3231_alarm1_t mode, bool armed = true);
     void GetAlarm1(sAlarmTime & pAlarmTime);
     void GetAlarmType1(eDS3231_alarm1_t & pDS3231_alarm1_t);
@@ -100,40 +94,131 @@ public:
     bool IsArmed2(void);
     void ClearAlarm2(void);
 
-    void GetOutput(eDS3231_sqw_t &pMode);
-    void SetOutput(eDS3231_sqw_t pMode);
+    // Set alarm 1 or 2 from register values made with DS3231AlarmCodec<N>::Make()
+    template <uint8_t N> void SetAlarm(const DS3231AlarmRegisters<N> & pRegisters, bool armed = true)
+    {
+        setAlarm((N == 1) ? DS3231_REG_ALARM_1 : DS3231_REG_ALARM_2, pRegisters.Values, DS3231AlarmTraits<N>::Size, DS3231AlarmTraits<N>::Flag, armed);
+    }
+
     void EnableOutput(bool enabled);
     bool IsOutput(void);
-    void Enable32kHz(bool enabled);
-    bool Is32kHz(void);
 
-    void ForceConversion(void);
+    void ForceConversion(void); // Convert now and wait for the new temperature
+    bool StartConversion(void); // Start a conversion without waiting, false while one is running
+    bool IsConverting(void); // True during a forced or automatic conversion, the temperature is not updated yet
+#if !defined(DS3231_NO_FLOAT)
     float GetTemperature(void);
+#endif
+    int16_t GetTemperatureRaw(void); // Temperature in quarters of a degree Celsius
+    static char * SPrintTemperature(char * pBuffer, int16_t pTemperature); // Print a raw temperature as "-12.75", returns the end of the string
+
+    void SetAging(int8_t pAging); // Crystal trim, one step is about 0.1ppm, positive values slow the clock down
+    int8_t GetAging(void);
 
     void SetBattery(bool timeBattery, bool squareBattery);
 
+    uint8_t GetStatus(void); // Raw status register, see DS3231_STATUS_*
+    bool IsOscillatorStopped(void); // True if the oscillator stopped since ClearOscillatorStopped(), time is not valid
+    void ClearOscillatorStopped(void);
+
 private:
-    inline uint8_t WireRead() {
-#if ARDUINO >= 100
-        return Wire.read();
-#else
-        return Wire.receive();
-#endif
-    };
+    void setAlarm(uint8_t reg, const uint8_t * values, uint8_t size, uint8_t flag, bool armed);
+    bool isAlarm(uint8_t flag, bool clear);
+    void armAlarm(uint8_t flag, bool armed);
+    bool isArmed(uint8_t flag);
+    void clearAlarm(uint8_t flag);
+};
 
-    inline void WireWrite(uint8_t data) {
-#if ARDUINO >= 100
-        Wire.write(data);
-#else
-        Wire.send(data);
-#endif
-    };
+// SQW frequency selection
+class DS3231RateSelectClass
+{
+public:
+    void GetOutput(eDS3231_sqw_t &pMode);
+    void SetOutput(eDS3231_sqw_t pMode);
+};
 
-    static uint8_t bcd2dec(uint8_t bcd);
-    static uint8_t dec2bcd(uint8_t dec);
+// 32kHz output
+class DS3231Output32kHzClass
+{
+public:
+    void Enable32kHz(bool enabled);
+    bool Is32kHz(void);
+};
+
+// DS1307 oscillator, stopped while the clock halt bit is set
+class DS1307ClockHaltClass
+{
+public:
+    bool IsOscillatorStopped(void); // True while the clock is halted, time is not valid
+    void ClearOscillatorStopped(void); // Start the oscillator
+};
+
+// Battery-backed SRAM of Size bytes from register Start, read and written in bursts
+template <uint8_t Start, uint8_t Size> class DS3231SramClass
+{
+public:
+    uint8_t GetSramSize(void) { return Size; }
+
+    bool ReadSram(uint8_t pOffset, uint8_t * pData, uint8_t pLength)
+    {
+        return ((uint16_t)pOffset + pLength <= Size) && DS3231Registers::Read(Start + pOffset, pData, pLength);
+    }
+
+    bool WriteSram(uint8_t pOffset, const uint8_t * pData, uint8_t pLength)
+    {
+        return ((uint16_t)pOffset + pLength <= Size) && DS3231Registers::Write(Start + pOffset, pData, pLength);
+    }
+};
 
-    void writeRegister8(uint8_t reg, uint8_t value);
-    uint8_t readRegister8(uint8_t reg);
+// Inherit TFeature only when the device has it
+template <bool Enabled, class TFeature> struct DS3231Feature
+{
+    typedef TFeature Type;
+};
+
+template <class TFeature> struct DS3231Feature<false, TFeature>
+{
+    class Type {};
 };
 
-#endif
\ No newline at end of file
+template <class TDevice>
+class DS323xClass
+    : public DS3231TimeClass
+    , public DS3231Feature<TDevice::HasControl, DS3231ControlClass>::Type
+    , public DS3231Feature<TDevice::HasRateSelect, DS3231RateSelectClass>::Type
+    , public DS3231Feature<TDevice::Has32kHz, DS3231Output32kHzClass>::Type
+    , public DS3231Feature<TDevice::HasClockHalt, DS1307ClockHaltClass>::Type
+    , public DS3231Feature<TDevice::SramSize != 0, DS3231SramClass<TDevice::SramStart, TDevice::SramSize> >::Type
+{
+public:
+    typedef TDevice Device;
+
+    bool Begin(void)
+    {
+        if (!DS3231Bus.Begin())
+        {
+            return false;
+        }
+
+        begin(this);
+
+        return true;
+    }
+
+private:
+    static void begin(DS3231ControlClass * pControl)
+    {
+        pControl->SetBattery(true, false);
+    }
+
+    static void begin(void *)
+    {
+    }
+};
+
+typedef DS323xClass<DS3231Traits> DS3231Class;
+typedef DS323xClass<DS3231MTraits> DS3231MClass;
+typedef DS323xClass<DS3232Traits> DS3232Class;
+typedef DS323xClass<DS1307Traits> DS1307Class;
+
+#endif
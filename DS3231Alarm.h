@@ -0,0 +1,174 @@
+/*
+DS3231Alarm.h - Alarm register codec for the DS3231 Real-Time Clock
+
+Both alarms share one layout: a register per field (seconds, minutes, hours,
+day/date) with the field's mask bit (AxMy) in bit 7 and DY/DT in bit 6 of the
+day/date register. Alarm 2 has no seconds register. The mode enums below
+carry the mask bits directly, bit n for field n and bit 4 for DY, so
+encoding and decoding are table lookups instead of per-mode branches.
+
+All encoding is constexpr: with constant arguments
+
+    constexpr DS3231AlarmRegisters<1> wakeUp = DS3231AlarmCodec<1>::Make(0, 7, 30, 0, DS3231_MATCH_H_M_S);
+    DS3231.SetAlarm(wakeUp);
+
+writes register values computed by the compiler.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Alarm_h
+#define _DS3231Alarm_h
+
+#include <stdint.h>
+
+#define DS3231_ALARM_SECOND         (0)
+#define DS3231_ALARM_MINUTE         (1)
+#define DS3231_ALARM_HOUR           (2)
+#define DS3231_ALARM_DAY            (3)
+
+#define DS3231_ALARM_MASK           (0b10000000)
+#define DS3231_ALARM_DY             (0b01000000)
+#define DS3231_ALARM_MODE_DY        (0b00010000)
+
+// Value bits of each field register, one byte per field starting with seconds
+#define DS3231_ALARM_VALUE_BITS     (0x3F3F7F7FUL)
+#define DS3231_ALARM_WEEKDAY_BITS   (0x0F)
+
+struct sAlarmTime
+{
+    uint8_t Day;
+    uint8_t Hour;
+    uint8_t Minute;
+    uint8_t Second;
+};
+
+typedef enum
+{
+    DS3231_EVERY_SECOND     = 0b00001111,
+    DS3231_MATCH_S          = 0b00001110,
+    DS3231_MATCH_M_S        = 0b00001100,
+    DS3231_MATCH_H_M_S      = 0b00001000,
+    DS3231_MATCH_DT_H_M_S   = 0b00000000,
+    DS3231_MATCH_DY_H_M_S   = 0b00010000
+} eDS3231_alarm1_t;
+
+typedef enum
+{
+    DS3231_EVERY_MINUTE = 0b00001110,
+    DS3231_MATCH_M      = 0b00001100,
+    DS3231_MATCH_H_M    = 0b00001000,
+    DS3231_MATCH_DT_H_M = 0b00000000,
+    DS3231_MATCH_DY_H_M = 0b00010000
+} eDS3231_alarm2_t;
+
+template <uint8_t N> struct DS3231AlarmTraits;
+
+template <> struct DS3231AlarmTraits<1>
+{
+    typedef eDS3231_alarm1_t Mode;
+    enum { First = DS3231_ALARM_SECOND, Size = 4, Flag = 0b00000001 };
+};
+
+template <> struct DS3231AlarmTraits<2>
+{
+    typedef eDS3231_alarm2_t Mode;
+    enum { First = DS3231_ALARM_MINUTE, Size = 3, Flag = 0b00000010 };
+};
+
+// Register values of alarm N in register order, alarm 2 leaves the last one unused
+template <uint8_t N> struct DS3231AlarmRegisters
+{
+    uint8_t Values[4];
+};
+
+template <uint8_t N> class DS3231AlarmCodec
+{
+public:
+    typedef DS3231AlarmTraits<N> Traits;
+    typedef typename Traits::Mode Mode;
+
+    static constexpr DS3231AlarmRegisters<N> Make(uint8_t pDay, uint8_t pHour, uint8_t pMinute, uint8_t pSecond, Mode pMode)
+    {
+        return DS3231AlarmRegisters<N>{ {
+            Encode(Traits::First + 0, Select(Traits::First + 0, pDay, pHour, pMinute, pSecond), pMode),
+            Encode(Traits::First + 1, Select(Traits::First + 1, pDay, pHour, pMinute, pSecond), pMode),
+            Encode(Traits::First + 2, Select(Traits::First + 2, pDay, pHour, pMinute, pSecond), pMode),
+            Encode(Traits::First + 3, Select(Traits::First + 3, pDay, pHour, pMinute, pSecond), pMode)
+        } };
+    }
+
+    // Register value of one field: BCD value, mask bit and, for the day register, DY
+    static constexpr uint8_t Encode(uint8_t pField, uint8_t pValue, uint8_t pMode)
+    {
+        return (pField > DS3231_ALARM_DAY) ? 0 :
+            (Bcd(pValue) & ValueBits(pField))
+            | (((pMode >> pField) & 1) ? DS3231_ALARM_MASK : 0)
+            | (((pField == DS3231_ALARM_DAY) && (pMode & DS3231_ALARM_MODE_DY)) ? DS3231_ALARM_DY : 0);
+    }
+
+    static Mode DecodeMode(const uint8_t * pValues)
+    {
+        uint8_t mode = 0;
+
+        for (uint8_t i = 0; i < Traits::Size; i++)
+        {
+            mode |= (pValues[i] >> 7) << (Traits::First + i);
+        }
+
+        if (pValues[Traits::Size - 1] & DS3231_ALARM_DY)
+        {
+            mode |= DS3231_ALARM_MODE_DY;
+        }
+
+        return (Mode)mode;
+    }
+
+    static void DecodeTime(sAlarmTime & pAlarmTime, const uint8_t * pValues)
+    {
+        const uint8_t * day = &pValues[DS3231_ALARM_DAY - Traits::First];
+
+        pAlarmTime.Second = (Traits::First == DS3231_ALARM_SECOND) ? Dec(pValues[0] & ValueBits(DS3231_ALARM_SECOND)) : 0;
+        pAlarmTime.Minute = Dec(pValues[DS3231_ALARM_MINUTE - Traits::First] & ValueBits(DS3231_ALARM_MINUTE));
+        pAlarmTime.Hour = Dec(pValues[DS3231_ALARM_HOUR - Traits::First] & ValueBits(DS3231_ALARM_HOUR));
+        pAlarmTime.Day = Dec(*day & ((*day & DS3231_ALARM_DY) ? DS3231_ALARM_WEEKDAY_BITS : ValueBits(DS3231_ALARM_DAY)));
+    }
+
+private:
+    static constexpr uint8_t ValueBits(uint8_t pField)
+    {
+        return (uint8_t)(DS3231_ALARM_VALUE_BITS >> (8 * pField));
+    }
+
+    static constexpr uint8_t Select(uint8_t pField, uint8_t pDay, uint8_t pHour, uint8_t pMinute, uint8_t pSecond)
+    {
+        return (pField == DS3231_ALARM_SECOND) ? pSecond :
+            (pField == DS3231_ALARM_MINUTE) ? pMinute :
+            (pField == DS3231_ALARM_HOUR) ? pHour :
+            (pField == DS3231_ALARM_DAY) ? pDay : 0;
+    }
+
+    static constexpr uint8_t Bcd(uint8_t pValue)
+    {
+        return ((pValue / 10) << 4) | (pValue % 10);
+    }
+
+    static constexpr uint8_t Dec(uint8_t pValue)
+    {
+        return (pValue >> 4) * 10 + (pValue & 0x0F);
+    }
+};
+
+#endif
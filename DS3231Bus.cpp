@@ -0,0 +1,191 @@
+#include "DS3231Bus.h"
+
+#if defined(DS3231_I2CDEV)
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+
+DS3231BusClass DS3231Bus;
+
+#if defined(DS3231_I2CDEV)
+
+#define DS3231_BUS_MAX_WRITE        (2 + 255)
+
+static int DS3231DefaultTransfer(int pFd, struct i2c_rdwr_ioctl_data * pData)
+{
+    return ioctl(pFd, I2C_RDWR, pData);
+}
+
+DS3231BusClass::DS3231BusClass(void)
+    : mFd(-1), mOwned(false), mTransfer(DS3231DefaultTransfer)
+{
+}
+
+bool DS3231BusClass::Begin(const char * pDevice)
+{
+    End();
+
+    mFd = open(pDevice, O_RDWR);
+    mOwned = true;
+
+    return mFd >= 0;
+}
+
+void DS3231BusClass::Begin(int pFd)
+{
+    End();
+
+    mFd = pFd;
+    mOwned = false;
+}
+
+void DS3231BusClass::End(void)
+{
+    if (mOwned && (mFd >= 0))
+    {
+        close(mFd);
+    }
+
+    mFd = -1;
+    mOwned = false;
+}
+
+void DS3231BusClass::SetTransfer(tDS3231Transfer pTransfer)
+{
+    mTransfer = pTransfer ? pTransfer : DS3231DefaultTransfer;
+}
+
+bool DS3231BusClass::Begin(void)
+{
+    return mFd >= 0;
+}
+
+bool DS3231BusClass::Read(uint8_t pAddress, const uint8_t * pHeader, uint8_t pHeaderLength, uint8_t * pData, uint8_t pLength)
+{
+    struct i2c_msg messages[2];
+
+    // Write of the header and read of the data with a repeated start, one ioctl
+    messages[0].addr = pAddress;
+    messages[0].flags = 0;
+    messages[0].len = pHeaderLength;
+    messages[0].buf = (uint8_t *)pHeader;
+
+    messages[1].addr = pAddress;
+    messages[1].flags = I2C_M_RD;
+    messages[1].len = pLength;
+    messages[1].buf = pData;
+
+    if (pHeaderLength == 0)
+    {
+        if (transfer(&messages[1], 1))
+            return true;
+    }
+    else if (transfer(messages, 2))
+    {
+        return true;
+    }
+
+    memset(pData, 0, pLength);
+    return false;
+}
+
+bool DS3231BusClass::Write(uint8_t pAddress, const uint8_t * pHeader, uint8_t pHeaderLength, const uint8_t * pData, uint8_t pLength)
+{
+    struct i2c_msg message;
+    uint8_t buffer[DS3231_BUS_MAX_WRITE];
+
+    if (pHeaderLength > 2)
+    {
+        return false;
+    }
+
+    memcpy(buffer, pHeader, pHeaderLength);
+    memcpy(buffer + pHeaderLength, pData, pLength);
+
+    message.addr = pAddress;
+    message.flags = 0;
+    message.len = pHeaderLength + pLength;
+    message.buf = buffer;
+
+    return transfer(&message, 1);
+}
+
+bool DS3231BusClass::transfer(struct i2c_msg * pMessages, uint8_t pCount)
+{
+    struct i2c_rdwr_ioctl_data data;
+
+    if (mFd < 0)
+    {
+        return false;
+    }
+
+    data.msgs = pMessages;
+    data.nmsgs = pCount;
+
+    return mTransfer(mFd, &data) == (int)pCount;
+}
+
+#else
+
+bool DS3231BusClass::Begin(void)
+{
+    Wire.begin();
+
+    return true;
+}
+
+bool DS3231BusClass::Read(uint8_t pAddress, const uint8_t * pHeader, uint8_t pHeaderLength, uint8_t * pData, uint8_t pLength)
+{
+    uint8_t i;
+
+    if (pHeaderLength > 0)
+    {
+        Wire.beginTransmission(pAddress);
+        for (i = 0; i < pHeaderLength; i++)
+        {
+            WireWrite(pHeader[i]);
+        }
+
+        if (Wire.endTransmission() != 0)
+        {
+            memset(pData, 0, pLength);
+            return false;
+        }
+    }
+
+    if (Wire.requestFrom(pAddress, pLength) != pLength)
+    {
+        memset(pData, 0, pLength);
+        return false;
+    }
+
+    for (i = 0; i < pLength; i++)
+    {
+        pData[i] = WireRead();
+    }
+
+    return true;
+}
+
+bool DS3231BusClass::Write(uint8_t pAddress, const uint8_t * pHeader, uint8_t pHeaderLength, const uint8_t * pData, uint8_t pLength)
+{
+    uint8_t i;
+
+    Wire.beginTransmission(pAddress);
+
+    for (i = 0; i < pHeaderLength; i++)
+    {
+        WireWrite(pHeader[i]);
+    }
+
+    for (i = 0; i < pLength; i++)
+    {
+        WireWrite(pData[i]);
+    }
+
+    return Wire.endTransmission() == 0;
+}
+
+#endif
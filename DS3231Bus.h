@@ -0,0 +1,108 @@
+/*
+DS3231Bus.h - I2C bus access for the DS3231 Real-Time Clock
+
+On Arduino the bus is Wire. On Linux (or with DS3231_I2CDEV defined) it is a
+/dev/i2c-N device driven with combined ioctl(I2C_RDWR) transfers, so a
+register read is one system call. The descriptor can be handed in with
+Begin(int), and the transfer replaced with SetTransfer(), to run against the
+kernel's i2c-stub or an in-process fake.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Bus_h
+#define _DS3231Bus_h
+
+#if !defined(ARDUINO) && !defined(DS3231_I2CDEV) && defined(__linux__)
+#define DS3231_I2CDEV
+#endif
+
+#if defined(DS3231_I2CDEV)
+#include <stdint.h>
+#include <stddef.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#elif ARDUINO >= 100
+#include "Arduino.h"
+#include <Wire.h>
+#else
+#include "WProgram.h"
+#include <Wire.h>
+#endif
+
+// Longest single transfer, including register address bytes
+#if defined(DS3231_I2CDEV)
+#define DS3231_BUS_MAX_LENGTH       (255)
+#elif defined(BUFFER_LENGTH)
+#define DS3231_BUS_MAX_LENGTH       (BUFFER_LENGTH)
+#else
+#define DS3231_BUS_MAX_LENGTH       (32)
+#endif
+
+#if defined(DS3231_I2CDEV)
+typedef int (*tDS3231Transfer)(int pFd, struct i2c_rdwr_ioctl_data * pData);
+#endif
+
+class DS3231BusClass
+{
+public:
+#if defined(DS3231_I2CDEV)
+    DS3231BusClass(void);
+
+    bool Begin(const char * pDevice); // Open a /dev/i2c-N device
+    void Begin(int pFd); // Use an already open descriptor, it is not closed by End()
+    void End(void);
+    void SetTransfer(tDS3231Transfer pTransfer); // Replace ioctl(I2C_RDWR), NULL restores it
+    int GetFileDescriptor(void) { return mFd; }
+#endif
+
+    bool Begin(void);
+
+    // Write pHeader (register address) then read pLength bytes. On failure pData is zeroed.
+    // On Arduino pLength is limited by the Wire buffer (32 bytes on AVR).
+    bool Read(uint8_t pAddress, const uint8_t * pHeader, uint8_t pHeaderLength, uint8_t * pData, uint8_t pLength);
+    // Write pHeader (register address) followed by pData in one transaction
+    bool Write(uint8_t pAddress, const uint8_t * pHeader, uint8_t pHeaderLength, const uint8_t * pData, uint8_t pLength);
+
+#if !defined(DS3231_I2CDEV)
+private:
+    inline uint8_t WireRead() {
+#if ARDUINO >= 100
+        return Wire.read();
+#else
+        return Wire.receive();
+#endif
+    };
+
+    inline void WireWrite(uint8_t data) {
+#if ARDUINO >= 100
+        Wire.write(data);
+#else
+        Wire.send(data);
+#endif
+    };
+#else
+private:
+    bool transfer(struct i2c_msg * pMessages, uint8_t pCount);
+
+    int mFd;
+    bool mOwned;
+    tDS3231Transfer mTransfer;
+#endif
+};
+
+extern DS3231BusClass DS3231Bus;
+
+#endif
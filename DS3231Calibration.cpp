@@ -0,0 +1,254 @@
+#include "DS3231Calibration.h"
+
+static volatile uint16_t sEdges;
+static volatile uint16_t sTarget;
+static volatile uint32_t sStart;
+static volatile uint32_t sEnd;
+
+static void DS3231CalibrationEdge(void)
+{
+    uint32_t now = micros();
+
+    if (sEdges > sTarget)
+    {
+        return;
+    }
+
+    if (sEdges == 0)
+    {
+        sStart = now;
+    }
+
+    sEnd = now;
+    sEdges++;
+}
+
+DS3231CalibrationClass::DS3231CalibrationClass(void)
+    : mDS3231(NULL), mPin(0), mReference(DS3231_CALIBRATION_1HZ), mWasOutput(false), mWas32kHz(false),
+      mWasRate(DS3231_1HZ), mPpm(0), mResidue(0), mBaseRaw(0), mBaseMillis(0),
+      mCorrectedMicros(0), mCorrectedMillis(0), mCorrectedFraction(0)
+{
+}
+
+bool DS3231CalibrationClass::Begin(DS3231Class & pDS3231, uint8_t pPin, eDS3231_calibration_t pReference)
+{
+    if (digitalPinToInterrupt(pPin) < 0)
+    {
+        return false;
+    }
+
+    mDS3231 = &pDS3231;
+    mPin = pPin;
+    mReference = pReference;
+
+    mWasOutput = mDS3231->IsOutput();
+    mWas32kHz = mDS3231->Is32kHz();
+    mDS3231->GetOutput(mWasRate);
+
+    if (mReference == DS3231_CALIBRATION_1HZ)
+    {
+        mDS3231->SetOutput(DS3231_1HZ);
+        mDS3231->EnableOutput(true);
+    }
+    else
+    {
+        mDS3231->Enable32kHz(true);
+    }
+
+    pinMode(mPin, INPUT_PULLUP);
+
+    sTarget = 0;
+    sEdges = 1;
+    attachInterrupt(digitalPinToInterrupt(mPin), DS3231CalibrationEdge, FALLING);
+
+    mBaseRaw = micros();
+    mBaseMillis = millis();
+    mCorrectedMicros = mBaseRaw;
+    mCorrectedMillis = mBaseMillis;
+    mCorrectedFraction = mBaseRaw % 1000;
+    mResidue = 0;
+
+    return true;
+}
+
+void DS3231CalibrationClass::End(void)
+{
+    if (!mDS3231)
+    {
+        return;
+    }
+
+    detachInterrupt(digitalPinToInterrupt(mPin));
+
+    mDS3231->SetOutput(mWasRate);
+    mDS3231->EnableOutput(mWasOutput);
+    mDS3231->Enable32kHz(mWas32kHz);
+    mDS3231 = NULL;
+}
+
+bool DS3231CalibrationClass::Measure(uint16_t pEdges)
+{
+    uint32_t measured;
+    uint16_t edges;
+    unsigned long start;
+    unsigned long timeout;
+
+    if (!mDS3231 || (pEdges == 0))
+    {
+        return false;
+    }
+
+    // Periods are counted from the first edge seen, so pEdges + 1 edges are needed
+    timeout = (uint32_t)(pEdges + 2) * 1000 / mReference + 100;
+
+    noInterrupts();
+    sTarget = pEdges;
+    sEdges = 0;
+    interrupts();
+
+    start = millis();
+    for (;;)
+    {
+        // Two bytes on AVR, the edge interrupt could change one between the reads
+        noInterrupts();
+        edges = sEdges;
+        interrupts();
+
+        if (edges > pEdges)
+        {
+            break;
+        }
+
+        if (millis() - start > timeout)
+        {
+            return false;
+        }
+    }
+
+    noInterrupts();
+    measured = sEnd - sStart;
+    interrupts();
+
+    update(); // Accumulate the time so far with the previous correction
+
+    // pEdges periods take pEdges * 1000000 / f us, the error relative to that in ppm
+    mPpm = (int32_t)(((int64_t)measured * mReference - (int64_t)pEdges * 1000000L) / pEdges);
+
+    return true;
+}
+
+uint32_t DS3231CalibrationClass::Micros(void)
+{
+    update();
+
+    return mCorrectedMicros;
+}
+
+uint32_t DS3231CalibrationClass::Millis(void)
+{
+    update();
+
+    return mCorrectedMillis;
+}
+
+void DS3231CalibrationClass::update(void)
+{
+    uint32_t now = micros();
+    uint32_t nowMillis = millis();
+    uint32_t elapsed = now - mBaseRaw;
+    uint32_t wraps;
+
+    // micros() wraps every 4294967.296 ms. millis() runs from the same timer and tells how many wraps were missed,
+    // a difference just below zero wraps around to a large number and rounds to none.
+    wraps = ((nowMillis - mBaseMillis) - elapsed / 1000 + 2147483UL) / 4294967UL;
+
+    for (; wraps > 0; wraps--)
+    {
+        advance(0x80000000UL);
+        advance(0x80000000UL);
+    }
+
+    if (elapsed >= 0x80000000UL)
+    {
+        advance(0x80000000UL);
+        elapsed -= 0x80000000UL;
+    }
+    advance(elapsed);
+
+    mBaseRaw = now;
+    mBaseMillis = nowMillis;
+}
+
+void DS3231CalibrationClass::advance(uint32_t pMicros)
+{
+    uint32_t rest = pMicros % 1000000UL;
+    int32_t whole = (int32_t)(pMicros / 1000000UL) * mPpm;   // us
+    int32_t milli = (int32_t)(rest / 1000) * mPpm;           // 1/1000 us
+    int32_t micro = (int32_t)(rest % 1000) * mPpm + mResidue; // 1/1000000 us
+    uint32_t corrected;
+
+    // pMicros * (1 - ppm / 1e6) in 32 bits, the part below 1us is carried to the next call
+    milli += micro / 1000;
+    micro %= 1000;
+    whole += milli / 1000;
+    mResidue = (milli % 1000) * 1000 + micro;
+
+    corrected = pMicros - whole;
+
+    mCorrectedMicros += corrected;
+    mCorrectedMillis += corrected / 1000;
+    mCorrectedFraction += corrected % 1000;
+    if (mCorrectedFraction >= 1000)
+    {
+        mCorrectedMillis++;
+        mCorrectedFraction -= 1000;
+    }
+}
+
+#if defined(OSCCAL)
+bool DS3231CalibrationClass::TrimOscillator(uint16_t pEdges)
+{
+    uint8_t best;
+    int32_t bestPpm;
+    int8_t direction;
+
+    if (!Measure(pEdges))
+    {
+        return false;
+    }
+
+    best = OSCCAL;
+    bestPpm = mPpm;
+
+    // A fast MCU needs a lower OSCCAL. Walk in that direction while the error shrinks.
+    direction = (mPpm > 0) ? -1 : 1;
+
+    for (uint8_t i = 0; (i < DS3231_CALIBRATION_TRIM_STEPS) && (mPpm != 0); i++)
+    {
+        if (((direction < 0) && (OSCCAL == 0)) || ((direction > 0) && (OSCCAL == 0xFF)))
+        {
+            break;
+        }
+
+        OSCCAL += direction;
+
+        if (!Measure(pEdges))
+        {
+            break;
+        }
+
+        if (labs(mPpm) >= labs(bestPpm))
+        {
+            break;
+        }
+
+        best = OSCCAL;
+        bestPpm = mPpm;
+    }
+
+    OSCCAL = best;
+    mPpm = bestPpm;
+
+    return true;
+}
+#endif
@@ -0,0 +1,79 @@
+/*
+DS3231Calibration.h - Calibrate the MCU clock against the DS3231 Real-Time Clock
+
+Counts micros() over a number of edges of the RTC's 1Hz SQW or 32kHz output
+(both open drain, connect to an interrupt pin) and derives the MCU clock
+error in ppm. Micros()/Millis() then return a clock corrected by that error,
+and on parts running from an internal RC oscillator TrimOscillator() moves
+OSCCAL towards zero error.
+
+Only one instance can measure at a time, the edge interrupt state is shared.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Calibration_h
+#define _DS3231Calibration_h
+
+#include "DS3231.h"
+
+#define DS3231_CALIBRATION_TRIM_STEPS   (16) // OSCCAL steps tried by TrimOscillator()
+
+typedef enum
+{
+    DS3231_CALIBRATION_1HZ      = 1,        // SQW pin, one edge per second
+    DS3231_CALIBRATION_32KHZ    = 32768     // 32K pin, interrupt load is high while measuring
+} eDS3231_calibration_t;
+
+class DS3231CalibrationClass
+{
+public:
+    DS3231CalibrationClass(void);
+
+    bool Begin(DS3231Class & pDS3231, uint8_t pPin, eDS3231_calibration_t pReference); // Enable the RTC output on pPin
+    void End(void); // Detach and restore the RTC's output settings
+
+    bool Measure(uint16_t pEdges); // Block for pEdges reference periods and update the ppm error, false on timeout
+
+    int32_t GetPpm(void) { return mPpm; } // MCU clock error, positive when the MCU runs fast
+
+    uint32_t Micros(void); // micros() corrected by the measured error, wraps like micros()
+    uint32_t Millis(void); // millis() corrected by the measured error, wraps like millis()
+
+#if defined(OSCCAL)
+    bool TrimOscillator(uint16_t pEdges); // Step OSCCAL to the value with the smallest error
+#endif
+
+private:
+    void update(void); // Accumulate the corrected time since the last call
+    void advance(uint32_t pMicros); // Add pMicros of micros() corrected by mPpm, at most 2^31
+
+    DS3231Class * mDS3231;
+    uint8_t mPin;
+    eDS3231_calibration_t mReference;
+    bool mWasOutput;
+    bool mWas32kHz;
+    eDS3231_sqw_t mWasRate;
+
+    int32_t mPpm;
+    int32_t mResidue;           // Correction below 1us not applied yet, in 1/1000000 us
+    uint32_t mBaseRaw;          // micros() at the last update
+    uint32_t mBaseMillis;       // millis() at the last update, counts the micros() wraps in between
+    uint32_t mCorrectedMicros;  // Corrected time at the last update
+    uint32_t mCorrectedMillis;
+    uint16_t mCorrectedFraction; // us of mCorrectedMillis' next millisecond
+};
+
+#endif
@@ -0,0 +1,27 @@
+/*
+DS3231Config.h - Build configuration of the DS3231 Real-Time Clock library
+
+Define these here or on the compiler command line (-D, build_flags):
+
+DS3231_NO_FLOAT     Drop GetTemperature(), which returns a float and links
+                    the float library. Use GetTemperatureRaw() and
+                    DS3231Class::SPrintTemperature() instead.
+
+Functions a sketch does not call are dropped by the linker in any build, so
+there is nothing else to switch off.
+
+The library itself never uses sprintf or atoi, formatting and parsing are
+done by CalendarHelperClass::SPrintTime(), SPrintNumber() and
+ParseStrDateTime().
+
+Footprints per example and configuration are tracked by extras/SizeReport.
+*/
+
+#pragma once
+
+#ifndef _DS3231Config_h
+#define _DS3231Config_h
+
+// #define DS3231_NO_FLOAT
+
+#endif
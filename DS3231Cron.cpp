@@ -0,0 +1,343 @@
+#include "DS3231Cron.h"
+
+DS3231CronClass::DS3231CronClass(void)
+    : mSecond(0), mMinute(0), mHour(0), mDay(0), mMonth(0), mWeekday(0), mAnyDay(false), mAnyWeekday(false)
+{
+}
+
+bool DS3231CronClass::Compile(const char * pExpression)
+{
+    const char * text = pExpression;
+    uint64_t masks[6];
+    bool any[6];
+    uint8_t fields = 0;
+    static const uint8_t minimum[6] = { 0, 0, 0, 1, 1, 0 };
+    static const uint8_t maximum[6] = { 59, 59, 23, 31, 12, 7 };
+    uint8_t offset;
+
+    mSecond = mMinute = mHour = mDay = mMonth = mWeekday = 0;
+
+    // Count the fields first, five fields leave the seconds out
+    for (const char * c = text; *c; )
+    {
+        while (*c == ' ')
+        {
+            c++;
+        }
+
+        if (*c)
+        {
+            fields++;
+        }
+
+        while (*c && (*c != ' '))
+        {
+            c++;
+        }
+    }
+
+    if ((fields != 5) && (fields != 6))
+    {
+        return false;
+    }
+
+    offset = 6 - fields;
+    masks[0] = 1;
+    any[0] = false;
+
+    for (uint8_t i = offset; i < 6; i++)
+    {
+        while (*text == ' ')
+        {
+            text++;
+        }
+
+        text = parseField(text, masks[i], minimum[i], maximum[i], any[i]);
+
+        if ((text == NULL) || ((*text != ' ') && (*text != '\0')))
+        {
+            return false;
+        }
+    }
+
+    // Sunday can be written as 0 or 7
+    if (masks[5] & (1 << 7))
+    {
+        masks[5] |= 1;
+    }
+
+    mSecond = masks[0];
+    mMinute = masks[1];
+    mHour = masks[2];
+    mDay = masks[3];
+    mMonth = masks[4];
+    mWeekday = masks[5] & 0x7F;
+    mAnyDay = any[3];
+    mAnyWeekday = any[5];
+
+    return true;
+}
+
+bool DS3231CronClass::Matches(sDateTime & pDateTime)
+{
+    return ((mSecond >> pDateTime.Second) & 1) && ((mMinute >> pDateTime.Minute) & 1) && ((mHour >> pDateTime.Hour) & 1) &&
+        ((mMonth >> pDateTime.Month) & 1) && matchesDay(pDateTime.Year, pDateTime.Month, pDateTime.Day);
+}
+
+bool DS3231CronClass::Next(sDateTime & pDateTime)
+{
+    uint16_t year = pDateTime.Year;
+    uint8_t month = pDateTime.Month;
+    uint8_t day = pDateTime.Day;
+    uint8_t hour = pDateTime.Hour;
+    uint8_t minute = pDateTime.Minute;
+    uint8_t second = pDateTime.Second + 1;
+    int8_t next;
+
+    // Each step either accepts a field or moves to the next candidate value of it,
+    // resetting the smaller fields. Overflowing values are carried by the next pass.
+    while (year <= DS3231_CRON_MAX_YEAR)
+    {
+        next = nextBit(mMonth, month, 12);
+        if (next < 0)
+        {
+            year++;
+            month = 1;
+            day = 1;
+            hour = minute = second = 0;
+            continue;
+        }
+
+        if (next != month)
+        {
+            month = next;
+            day = 1;
+            hour = minute = second = 0;
+        }
+
+        if (day > monthLength(year, month))
+        {
+            month++;
+            day = 1;
+            hour = minute = second = 0;
+            continue;
+        }
+
+        if (!matchesDay(year, month, day))
+        {
+            day++;
+            hour = minute = second = 0;
+            continue;
+        }
+
+        next = nextBit(mHour, hour, 23);
+        if (next < 0)
+        {
+            day++;
+            hour = minute = second = 0;
+            continue;
+        }
+
+        if (next != hour)
+        {
+            hour = next;
+            minute = second = 0;
+        }
+
+        next = nextBit(mMinute, minute, 59);
+        if (next < 0)
+        {
+            hour++;
+            minute = second = 0;
+            continue;
+        }
+
+        if (next != minute)
+        {
+            minute = next;
+            second = 0;
+        }
+
+        next = nextBit(mSecond, second, 59);
+        if (next < 0)
+        {
+            minute++;
+            second = 0;
+            continue;
+        }
+
+        pDateTime.Year = year;
+        pDateTime.Month = month;
+        pDateTime.Day = day;
+        pDateTime.DayOfWeek = CalendarHelperClass::GetDayOfWeek(year, month, day) + 1;
+        pDateTime.Hour = hour;
+        pDateTime.Minute = minute;
+        pDateTime.Second = next;
+
+        return true;
+    }
+
+    return false;
+}
+
+bool DS3231CronClass::SetAlarm1(DS3231ControlClass & pDS3231, sDateTime & pDateTime)
+{
+    if (!Next(pDateTime))
+    {
+        return false;
+    }
+
+    pDS3231.SetAlarm1(pDateTime.Day, pDateTime.Hour, pDateTime.Minute, pDateTime.Second, DS3231_MATCH_DT_H_M_S);
+
+    return true;
+}
+
+bool DS3231CronClass::SetAlarm2(DS3231ControlClass & pDS3231, sDateTime & pDateTime)
+{
+    if ((mSecond != 1) || !Next(pDateTime))
+    {
+        return false;
+    }
+
+    pDS3231.SetAlarm2(pDateTime.Day, pDateTime.Hour, pDateTime.Minute, DS3231_MATCH_DT_H_M);
+
+    return true;
+}
+
+const char * DS3231CronClass::parseField(const char * pText, uint64_t & pMask, uint8_t pMin, uint8_t pMax, bool & pAny)
+{
+    uint8_t first;
+    uint8_t last;
+    uint8_t step;
+
+    pMask = 0;
+    pAny = (*pText == '*');
+
+    for (;;)
+    {
+        if (*pText == '*')
+        {
+            first = pMin;
+            last = pMax;
+            pText++;
+        }
+        else
+        {
+            pText = parseNumber(pText, first);
+            if (pText == NULL)
+            {
+                return NULL;
+            }
+
+            last = first;
+            if (*pText == '-')
+            {
+                pText = parseNumber(pText + 1, last);
+                if (pText == NULL)
+                {
+                    return NULL;
+                }
+            }
+            else if (*pText == '/')
+            {
+                // "a/n" steps from a to the end of the range
+                last = pMax;
+            }
+        }
+
+        step = 1;
+        if (*pText == '/')
+        {
+            pText = parseNumber(pText + 1, step);
+            if ((pText == NULL) || (step == 0))
+            {
+                return NULL;
+            }
+        }
+
+        if ((first < pMin) || (last > pMax) || (first > last))
+        {
+            return NULL;
+        }
+
+        for (uint8_t value = first; value <= last; value += step)
+        {
+            pMask |= (uint64_t)1 << value;
+
+            if (last - value < step)
+            {
+                break;
+            }
+        }
+
+        if (*pText != ',')
+        {
+            return pText;
+        }
+
+        pText++;
+    }
+}
+
+const char * DS3231CronClass::parseNumber(const char * pText, uint8_t & pValue)
+{
+    uint16_t value = 0;
+    const char * start = pText;
+
+    while ((*pText >= '0') && (*pText <= '9') && (value < 100))
+    {
+        value = value * 10 + (*pText - '0');
+        pText++;
+    }
+
+    if ((pText == start) || (value >= 100))
+    {
+        return NULL;
+    }
+
+    pValue = value;
+
+    return pText;
+}
+
+int8_t DS3231CronClass::nextBit(uint64_t pMask, uint8_t pFrom, uint8_t pMax)
+{
+    if (pFrom > pMax)
+    {
+        return -1;
+    }
+
+    pMask >>= pFrom;
+
+    if (pMask == 0)
+    {
+        return -1;
+    }
+
+    pFrom += __builtin_ctzll(pMask);
+
+    return (pFrom <= pMax) ? (int8_t)pFrom : -1;
+}
+
+uint8_t DS3231CronClass::monthLength(uint16_t pYear, uint8_t pMonth)
+{
+    if ((pMonth == 2) && LEAP_YEAR(pYear - BASE_YEAR))
+    {
+        return 29;
+    }
+
+    return pgm_read_byte(MONTH_DAYS + pMonth - 1);
+}
+
+bool DS3231CronClass::matchesDay(uint16_t pYear, uint8_t pMonth, uint8_t pDay)
+{
+    bool day = (mDay >> pDay) & 1;
+    bool weekday = (mWeekday >> CalendarHelperClass::GetDayOfWeek(pYear, pMonth, pDay)) & 1;
+
+    if (mAnyDay || mAnyWeekday)
+    {
+        return day && weekday;
+    }
+
+    return day || weekday;
+}
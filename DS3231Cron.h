@@ -0,0 +1,74 @@
+/*
+DS3231Cron.h - Cron schedules for the DS3231 Real-Time Clock
+
+Compiles a cron expression into one bitmask per field and finds the next
+fire time by jumping field by field, so the search costs a few steps per
+field instead of one per second. SetAlarm1()/SetAlarm2() program the next
+fire time as an exact date match, the MCU then only wakes when the schedule
+fires:
+
+    "0 0/15 8-17 * * 1-5"   every 15 minutes from 08:00 to 17:45, monday to friday
+
+Fields are "second minute hour day month weekday", or the usual five without
+seconds (second 0). Each field is a list of "*", "a", "a-b", optionally
+followed by "/step"; weekday 0 and 7 are sunday. As in cron, when both day and
+weekday are restricted a time matches either of them.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Cron_h
+#define _DS3231Cron_h
+
+#include "DS3231.h"
+
+#define DS3231_CRON_MAX_YEAR        (2099) // Last year the RTC counts without the century bit
+
+class DS3231CronClass
+{
+public:
+    DS3231CronClass(void);
+
+    bool Compile(const char * pExpression); // False on a syntax or range error, the schedule then never fires
+
+    bool Matches(sDateTime & pDateTime); // True if the schedule fires at pDateTime
+    bool Next(sDateTime & pDateTime); // Advance pDateTime to the next fire time after it, false if there is none before 2100
+
+    // Program the alarm with the next fire time after pDateTime (now) and return that time
+    // in pDateTime. A fire time more than a month ahead can wake early on the same date of
+    // an earlier month: check Matches() after each wake, or compare with the time returned
+    // here as DS3231SleepClass::Sleep() does.
+    bool SetAlarm1(DS3231ControlClass & pDS3231, sDateTime & pDateTime);
+    bool SetAlarm2(DS3231ControlClass & pDS3231, sDateTime & pDateTime); // Whole minutes only, false if the schedule has other seconds
+
+private:
+    static const char * parseField(const char * pText, uint64_t & pMask, uint8_t pMin, uint8_t pMax, bool & pAny);
+    static const char * parseNumber(const char * pText, uint8_t & pValue);
+    static int8_t nextBit(uint64_t pMask, uint8_t pFrom, uint8_t pMax);
+    static uint8_t monthLength(uint16_t pYear, uint8_t pMonth);
+
+    bool matchesDay(uint16_t pYear, uint8_t pMonth, uint8_t pDay);
+
+    uint64_t mSecond;
+    uint64_t mMinute;
+    uint32_t mHour;
+    uint32_t mDay;      // Bits 1 to 31
+    uint16_t mMonth;    // Bits 1 to 12
+    uint8_t mWeekday;   // Bit 0 is sunday
+    bool mAnyDay;       // Day field starts with '*'
+    bool mAnyWeekday;
+};
+
+#endif
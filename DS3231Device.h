@@ -0,0 +1,52 @@
+/*
+DS3231Device.h - Device variants supported by the DS3231 Real-Time Clock driver
+
+Each traits struct lists what a part has. DS323xClass<Traits> only inherits
+the feature classes a part supports, so calling e.g. SetAlarm1() on a
+DS1307Class does not compile.
+
+    HasControl      Control/status registers: alarms, INT/SQW, temperature, aging, OSF
+    HasRateSelect   SQW frequency selection (the DS3231M is fixed at 1Hz)
+    Has32kHz        Switchable 32kHz output
+    HasClockHalt    DS1307 CH bit instead of the OSF flag
+    SramStart/Size  Battery-backed SRAM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Device_h
+#define _DS3231Device_h
+
+struct DS3231Traits
+{
+    enum { HasControl = 1, HasRateSelect = 1, Has32kHz = 1, HasClockHalt = 0, SramStart = 0x00, SramSize = 0 };
+};
+
+struct DS3231MTraits
+{
+    enum { HasControl = 1, HasRateSelect = 0, Has32kHz = 1, HasClockHalt = 0, SramStart = 0x00, SramSize = 0 };
+};
+
+struct DS3232Traits
+{
+    enum { HasControl = 1, HasRateSelect = 1, Has32kHz = 1, HasClockHalt = 0, SramStart = 0x14, SramSize = 236 };
+};
+
+struct DS1307Traits
+{
+    enum { HasControl = 0, HasRateSelect = 0, Has32kHz = 0, HasClockHalt = 1, SramStart = 0x08, SramSize = 56 };
+};
+
+#endif
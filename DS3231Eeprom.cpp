@@ -0,0 +1,412 @@
+#include "DS3231Eeprom.h"
+
+#define DS3231_EEPROM_EMPTY         (0xFFFFFFFFUL) // Timestamp of an erased record
+
+DS3231EepromClass::DS3231EepromClass(uint8_t pAddress, uint16_t pSize)
+    : mAddress(pAddress), mSize(pSize), mBusy(false), mPageAddress(0), mDirty(0)
+{
+    memset(mPage, 0, sizeof(mPage));
+}
+
+bool DS3231EepromClass::Begin(void)
+{
+    mBusy = false;
+    mDirty = 0;
+
+    return DS3231Bus.Begin();
+}
+
+bool DS3231EepromClass::Read(uint16_t pAddress, uint8_t * pData, uint16_t pLength)
+{
+    uint8_t header[2];
+    uint8_t chunk;
+    uint16_t address = pAddress;
+    uint8_t * data = pData;
+    uint16_t length = pLength;
+
+    if (((uint32_t)pAddress + pLength > mSize) || !wait())
+    {
+        return false;
+    }
+
+    // The address pointer auto-increments across pages on reads
+    while (length)
+    {
+        chunk = (length < DS3231_BUS_MAX_LENGTH) ? length : DS3231_BUS_MAX_LENGTH;
+
+        header[0] = address >> 8;
+        header[1] = (uint8_t)address;
+
+        if (!DS3231Bus.Read(mAddress, header, 2, data, chunk))
+        {
+            return false;
+        }
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+
+    // Bytes still waiting in the page buffer are newer than the EEPROM's
+    for (uint8_t i = 0; mDirty && (i < DS3231_EEPROM_PAGE); i++)
+    {
+        address = mPageAddress + i;
+
+        if (((mDirty >> i) & 1) && (address >= pAddress) && (address < pAddress + pLength))
+        {
+            pData[address - pAddress] = mPage[i];
+        }
+    }
+
+    return true;
+}
+
+bool DS3231EepromClass::Write(uint16_t pAddress, const uint8_t * pData, uint16_t pLength)
+{
+    uint16_t page;
+    uint8_t offset;
+    uint8_t count;
+
+    if ((uint32_t)pAddress + pLength > mSize)
+    {
+        return false;
+    }
+
+    while (pLength)
+    {
+        page = pAddress & ~(DS3231_EEPROM_PAGE - 1);
+
+        // Leaving the buffered page, burst it out. Its write cycle runs while the next page fills up.
+        if (mDirty && (page != mPageAddress))
+        {
+            if (!flush())
+            {
+                return false;
+            }
+        }
+
+        mPageAddress = page;
+        offset = pAddress - page;
+        count = (pLength < DS3231_EEPROM_PAGE - offset) ? pLength : DS3231_EEPROM_PAGE - offset;
+
+        memcpy(&mPage[offset], pData, count);
+        mDirty |= ((count == 32) ? 0xFFFFFFFFUL : ((1UL << count) - 1)) << offset;
+
+        pAddress += count;
+        pData += count;
+        pLength -= count;
+    }
+
+    return true;
+}
+
+bool DS3231EepromClass::Flush(void)
+{
+    return flush() && wait();
+}
+
+bool DS3231EepromClass::flush(void)
+{
+    uint8_t first;
+    uint8_t last;
+
+    // One burst per run of written bytes, unwritten bytes in between keep their EEPROM content
+    for (first = 0; first < DS3231_EEPROM_PAGE; first = last)
+    {
+        if (!((mDirty >> first) & 1))
+        {
+            last = first + 1;
+            continue;
+        }
+
+        for (last = first; (last < DS3231_EEPROM_PAGE) && ((mDirty >> last) & 1); last++)
+        {
+        }
+
+        if (!writeBurst(mPageAddress + first, &mPage[first], last - first))
+        {
+            return false;
+        }
+    }
+
+    mDirty = 0;
+
+    return true;
+}
+
+bool DS3231EepromClass::wait(void)
+{
+    if (!mBusy)
+    {
+        return true;
+    }
+
+    // The EEPROM does not acknowledge its address until the write cycle is done
+    for (uint16_t i = 0; i < DS3231_EEPROM_POLL_LIMIT; i++)
+    {
+        if (DS3231Bus.Write(mAddress, NULL, 0, NULL, 0))
+        {
+            mBusy = false;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DS3231EepromClass::writeBurst(uint16_t pAddress, const uint8_t * pData, uint8_t pLength)
+{
+    uint8_t header[2];
+    uint8_t chunk;
+
+    while (pLength)
+    {
+        // The two address bytes take part of the bus transfer
+        chunk = (pLength < DS3231_BUS_MAX_LENGTH - 2) ? pLength : DS3231_BUS_MAX_LENGTH - 2;
+
+        header[0] = pAddress >> 8;
+        header[1] = (uint8_t)pAddress;
+
+        if (!wait() || !DS3231Bus.Write(mAddress, header, 2, pData, chunk))
+        {
+            return false;
+        }
+
+        mBusy = true;
+
+        pAddress += chunk;
+        pData += chunk;
+        pLength -= chunk;
+    }
+
+    return true;
+}
+
+DS3231EepromLogClass::DS3231EepromLogClass(DS3231EepromClass & pEeprom)
+    : mEeprom(pEeprom), mStart(0), mSlots(0), mRecordSize(0), mHead(0), mCount(0), mLap(0), mLast(0)
+{
+}
+
+bool DS3231EepromLogClass::Begin(uint16_t pStart, uint16_t pSize, uint8_t pRecordSize)
+{
+    uint32_t seconds;
+    uint32_t newest = 0;
+    uint8_t lap;
+    uint8_t newestLap = 0;
+    uint16_t highest = 0;
+    bool found = false;
+
+    if ((pRecordSize <= DS3231_EEPROM_LOG_OVERHEAD) || (DS3231_EEPROM_PAGE % pRecordSize != 0) ||
+        (pStart % pRecordSize != 0) || (pSize < pRecordSize) || ((uint32_t)pStart + pSize > mEeprom.GetSize()))
+    {
+        return false;
+    }
+
+    mStart = pStart;
+    mRecordSize = pRecordSize;
+    mSlots = pSize / pRecordSize;
+    mHead = 0;
+    mCount = 0;
+    mLap = 0;
+    mLast = 0;
+
+    // The newest record has the latest timestamp, then the latest lap, then the highest slot.
+    // Laps of the records in the ring differ by one at most, so they compare modulo 256.
+    for (uint16_t i = 0; i < mSlots; i++)
+    {
+        if (!readSlot(i, seconds, NULL, &lap))
+        {
+            continue;
+        }
+
+        highest = i;
+
+        if (!found || (seconds > newest) || ((seconds == newest) && ((int8_t)(lap - newestLap) >= 0)))
+        {
+            newest = seconds;
+            newestLap = lap;
+            mHead = (i + 1) % mSlots;
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        mLap = (mHead == 0) ? newestLap + 1 : newestLap;
+        mLast = newest;
+
+        // A record past the head is left from the previous lap, so the ring is full. The head slot alone
+        // does not tell: a write cut short tears it, and with it the rest of its page burst.
+        mCount = ((mHead == 0) || (highest >= mHead)) ? mSlots : mHead;
+    }
+
+    return true;
+}
+
+bool DS3231EepromLogClass::Append(uint32_t pSeconds, const uint8_t * pPayload)
+{
+    uint8_t record[DS3231_EEPROM_PAGE];
+    uint8_t size = mRecordSize - DS3231_EEPROM_LOG_OVERHEAD;
+
+    if (mSlots == 0)
+    {
+        return false;
+    }
+
+    // Timestamps never go backwards, Find() depends on it
+    if ((mCount != 0) && (pSeconds < mLast))
+    {
+        pSeconds = mLast;
+    }
+
+    record[0] = (uint8_t)pSeconds;
+    record[1] = (uint8_t)(pSeconds >> 8);
+    record[2] = (uint8_t)(pSeconds >> 16);
+    record[3] = (uint8_t)(pSeconds >> 24);
+    record[4] = mLap;
+    memcpy(&record[5], pPayload, size);
+    record[mRecordSize - 1] = crc8(record, mRecordSize - 1);
+
+    if (!mEeprom.Write(mStart + mHead * mRecordSize, record, mRecordSize))
+    {
+        return false;
+    }
+
+    mHead = (mHead + 1) % mSlots;
+    if (mHead == 0)
+    {
+        mLap++;
+    }
+    if (mCount < mSlots)
+    {
+        mCount++;
+    }
+    mLast = pSeconds;
+
+    return true;
+}
+
+bool DS3231EepromLogClass::Append(DS3231TimeClass & pDS3231, const uint8_t * pPayload)
+{
+    sDateTime datetime;
+    uint32_t seconds;
+
+    pDS3231.GetDateTime(datetime);
+    CalendarHelperClass::ConvertToSeconds(seconds, datetime);
+
+    return Append(seconds, pPayload);
+}
+
+bool DS3231EepromLogClass::Clear(void)
+{
+    uint8_t erased[DS3231_EEPROM_PAGE];
+    uint16_t length = mSlots * mRecordSize;
+    uint16_t chunk;
+
+    memset(erased, 0xFF, sizeof(erased));
+
+    for (uint16_t offset = 0; offset < length; offset += chunk)
+    {
+        chunk = (length - offset < DS3231_EEPROM_PAGE) ? length - offset : DS3231_EEPROM_PAGE;
+
+        if (!mEeprom.Write(mStart + offset, erased, chunk))
+        {
+            return false;
+        }
+    }
+
+    mHead = 0;
+    mCount = 0;
+    mLap = 0;
+    mLast = 0;
+
+    return mEeprom.Flush();
+}
+
+bool DS3231EepromLogClass::Read(uint16_t pIndex, uint32_t & pSeconds, uint8_t * pPayload)
+{
+    if (pIndex >= mCount)
+    {
+        return false;
+    }
+
+    return readSlot(slot(pIndex), pSeconds, pPayload);
+}
+
+uint16_t DS3231EepromLogClass::Find(uint32_t pSeconds)
+{
+    uint16_t low = 0;
+    uint16_t high = mCount;
+    uint16_t middle;
+    uint32_t seconds;
+
+    // Records are in time order from the oldest on, a corrupt one counts as earlier
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+
+        if (!readSlot(slot(middle), seconds, NULL) || (seconds < pSeconds))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+bool DS3231EepromLogClass::readSlot(uint16_t pSlot, uint32_t & pSeconds, uint8_t * pPayload, uint8_t * pLap)
+{
+    uint8_t record[DS3231_EEPROM_PAGE];
+
+    if (!mEeprom.Read(mStart + pSlot * mRecordSize, record, mRecordSize) ||
+        (crc8(record, mRecordSize - 1) != record[mRecordSize - 1]))
+    {
+        return false;
+    }
+
+    pSeconds = (uint32_t)record[0] | ((uint32_t)record[1] << 8) | ((uint32_t)record[2] << 16) | ((uint32_t)record[3] << 24);
+
+    if (pSeconds == DS3231_EEPROM_EMPTY)
+    {
+        return false;
+    }
+
+    if (pPayload != NULL)
+    {
+        memcpy(pPayload, &record[5], mRecordSize - DS3231_EEPROM_LOG_OVERHEAD);
+    }
+
+    if (pLap != NULL)
+    {
+        *pLap = record[4];
+    }
+
+    return true;
+}
+
+uint16_t DS3231EepromLogClass::slot(uint16_t pIndex)
+{
+    return (mHead + mSlots - mCount + pIndex) % mSlots;
+}
+
+uint8_t DS3231EepromLogClass::crc8(const uint8_t * pData, uint8_t pLength)
+{
+    uint8_t crc = 0xFF;
+
+    // CRC-8, polynomial x^8 + x^2 + x + 1
+    for (uint8_t i = 0; i < pLength; i++)
+    {
+        crc ^= pData[i];
+
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
@@ -0,0 +1,108 @@
+/*
+DS3231Eeprom.h - AT24C32 EEPROM found on most DS3231 modules
+
+The EEPROM sits at 0x57 on the RTC's bus and is reached through DS3231Bus.
+Writes are collected in a page buffer and written as one burst when a write
+leaves the page or on Flush(), so a page costs one ~5ms write cycle instead of
+one per byte. Completion of a write cycle is detected by ACK polling. Bursts
+are also limited by the bus transfer (30 data bytes per write on AVR, whose
+Wire buffer also holds the two address bytes).
+
+DS3231EepromLogClass keeps fixed size timestamped records in a ring over an
+EEPROM region. Each record is written once per lap, so all cells wear evenly,
+and the newest record is found again after a restart by its timestamp. Records
+also carry the lap they were written in: several records can share a second,
+and among those the newest is the last slot of the latest lap.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Eeprom_h
+#define _DS3231Eeprom_h
+
+#include "DS3231.h"
+
+#define DS3231_EEPROM_ADDRESS       (0x57)
+#define DS3231_EEPROM_SIZE          (4096)
+#define DS3231_EEPROM_PAGE          (32)
+#define DS3231_EEPROM_POLL_LIMIT    (1000)  // ACK polls before a write cycle counts as failed, well over 10ms at 400kHz
+
+#define DS3231_EEPROM_LOG_OVERHEAD  (6)     // Timestamp, lap and CRC of each record
+
+class DS3231EepromClass
+{
+public:
+    DS3231EepromClass(uint8_t pAddress = DS3231_EEPROM_ADDRESS, uint16_t pSize = DS3231_EEPROM_SIZE);
+
+    bool Begin(void);
+
+    bool Read(uint16_t pAddress, uint8_t * pData, uint16_t pLength); // Sequential read, sees data not flushed yet
+    bool Write(uint16_t pAddress, const uint8_t * pData, uint16_t pLength); // Buffered, see Flush()
+    bool Flush(void); // Write the page buffer and wait for the write cycle
+
+    uint16_t GetSize(void) { return mSize; }
+
+private:
+    bool flush(void);
+    bool wait(void);
+    bool writeBurst(uint16_t pAddress, const uint8_t * pData, uint8_t pLength);
+
+    uint8_t mAddress;
+    uint16_t mSize;
+    bool mBusy;             // A write cycle may still run
+
+    uint8_t mPage[DS3231_EEPROM_PAGE];
+    uint16_t mPageAddress;
+    uint32_t mDirty;        // Bytes of mPage that were written, bit n for byte n
+};
+
+class DS3231EepromLogClass
+{
+public:
+    DS3231EepromLogClass(DS3231EepromClass & pEeprom);
+
+    // Use pSize bytes from pStart for records of pRecordSize bytes, timestamp, lap and CRC included.
+    // pRecordSize has to divide the page size, so a record never spans two pages.
+    bool Begin(uint16_t pStart, uint16_t pSize, uint8_t pRecordSize);
+
+    bool Append(uint32_t pSeconds, const uint8_t * pPayload); // Buffered, Flush() to make it persistent
+    bool Append(DS3231TimeClass & pDS3231, const uint8_t * pPayload); // Stamped with the RTC's time
+    bool Flush(void) { return mEeprom.Flush(); }
+    bool Clear(void);
+
+    uint16_t GetCount(void) { return mCount; }
+    uint8_t GetPayloadSize(void) { return mRecordSize - DS3231_EEPROM_LOG_OVERHEAD; }
+
+    bool Read(uint16_t pIndex, uint32_t & pSeconds, uint8_t * pPayload); // pIndex 0 is the oldest record, false if it is corrupt
+    uint16_t Find(uint32_t pSeconds); // Index of the first record at or after pSeconds, GetCount() if there is none
+
+private:
+    bool readSlot(uint16_t pSlot, uint32_t & pSeconds, uint8_t * pPayload, uint8_t * pLap = NULL);
+    uint16_t slot(uint16_t pIndex);
+
+    static uint8_t crc8(const uint8_t * pData, uint8_t pLength);
+
+    DS3231EepromClass & mEeprom;
+    uint16_t mStart;
+    uint16_t mSlots;
+    uint8_t mRecordSize;
+
+    uint16_t mHead;         // Slot of the next record
+    uint16_t mCount;
+    uint8_t mLap;           // Lap of the next record, counts up each time mHead wraps to slot 0
+    uint32_t mLast;         // Timestamp of the newest record
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "DS3231Log.h"
+
+DS3231LogWriterClass::DS3231LogWriterClass(Print & pOutput)
+    : mOutput(pOutput), mSynced(false), mSeconds(0), mTemperature(0)
+{
+}
+
+void DS3231LogWriterClass::Begin(void)
+{
+    mSynced = false;
+}
+
+size_t DS3231LogWriterClass::Append(uint32_t pSeconds, int16_t pTemperature)
+{
+    uint8_t buffer[DS3231_LOG_RECORD_MAX];
+    uint8_t length;
+    int32_t delta = (int32_t)(pSeconds - mSeconds);
+
+    if (!mSynced || (delta > DS3231_LOG_MAX_DELTA) || (delta < -DS3231_LOG_MAX_DELTA))
+    {
+        length = DS3231LogFormat::PutSync(buffer, pSeconds, pTemperature);
+        mSynced = true;
+    }
+    else
+    {
+        length = DS3231LogFormat::PutVarint(buffer, DS3231LogFormat::ZigZag(delta) + 1);
+        length += DS3231LogFormat::PutVarint(buffer + length, DS3231LogFormat::ZigZag(pTemperature - mTemperature));
+    }
+
+    mSeconds = pSeconds;
+    mTemperature = pTemperature;
+
+    return mOutput.write(buffer, length);
+}
+
+size_t DS3231LogWriterClass::Append(sDateTime & pDateTime, int16_t pTemperature)
+{
+    uint32_t seconds;
+
+    CalendarHelperClass::ConvertToSeconds(seconds, pDateTime);
+
+    return Append(seconds, pTemperature);
+}
+
+size_t DS3231LogWriterClass::Append(DS3231Class & pDS3231)
+{
+    sDateTime datetime;
+
+    pDS3231.GetDateTime(datetime);
+
+    return Append(datetime, pDS3231.GetTemperatureRaw());
+}
@@ -0,0 +1,45 @@
+/*
+DS3231Log.h - Binary time and temperature log writer for the DS3231 Real-Time Clock
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Log_h
+#define _DS3231Log_h
+
+#include "DS3231.h"
+#include "DS3231LogFormat.h"
+
+#define DS3231_LOG_MAX_DELTA        (0x3FFFFFFFL) // Larger time deltas are written as a sync record
+
+class DS3231LogWriterClass
+{
+public:
+    DS3231LogWriterClass(Print & pOutput);
+
+    void Begin(void); // Start a new segment, the next sample is written as a sync record
+
+    size_t Append(uint32_t pSeconds, int16_t pTemperature); // Seconds since 2000, quarters of degree Celsius
+    size_t Append(sDateTime & pDateTime, int16_t pTemperature);
+    size_t Append(DS3231Class & pDS3231); // Sample the RTC's time and temperature
+
+private:
+    Print & mOutput;
+    bool mSynced;
+    uint32_t mSeconds;
+    int16_t mTemperature;
+};
+
+#endif
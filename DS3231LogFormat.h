@@ -0,0 +1,187 @@
+/*
+DS3231LogFormat.h - Binary time and temperature log format for the DS3231 Real-Time Clock
+
+This header has no Arduino dependencies so the same decoder can be built on
+the host to read logs pulled off an EEPROM or SD card.
+
+A log is a sequence of records:
+
+    sync record:   0x00, seconds (uint32 LE), temperature (int16 LE)
+    delta record:  varint(zigzag(seconds delta) + 1), varint(zigzag(temperature delta))
+
+Seconds are counted since Jan 1st of 2000 (see CalendarHelperClass::ConvertToSeconds)
+and temperature is in quarters of a degree Celsius (see DS3231Class::GetTemperatureRaw).
+A log must start with a sync record; writers emit a new one after a restart or
+when a delta does not fit. With samples less than a minute apart and temperature
+changing by less than 16 degrees, a delta record takes 2 bytes.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231LogFormat_h
+#define _DS3231LogFormat_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define DS3231_LOG_SYNC             (0x00)
+#define DS3231_LOG_SYNC_SIZE        (7)
+#define DS3231_LOG_VARINT_MAX       (5)
+#define DS3231_LOG_RECORD_MAX       (DS3231_LOG_VARINT_MAX * 2)
+
+class DS3231LogFormat
+{
+public:
+    static inline uint32_t ZigZag(int32_t pValue)
+    {
+        return ((uint32_t)pValue << 1) ^ (uint32_t)(pValue >> 31);
+    }
+
+    static inline int32_t UnZigZag(uint32_t pValue)
+    {
+        return (int32_t)(pValue >> 1) ^ -(int32_t)(pValue & 1);
+    }
+
+    // Encode pValue into pBuffer, returns the number of bytes used (1 to 5)
+    static inline uint8_t PutVarint(uint8_t * pBuffer, uint32_t pValue)
+    {
+        uint8_t length = 0;
+
+        while (pValue >= 0x80)
+        {
+            pBuffer[length++] = (uint8_t)pValue | 0x80;
+            pValue >>= 7;
+        }
+        pBuffer[length++] = (uint8_t)pValue;
+
+        return length;
+    }
+
+    // Decode a varint from pBuffer, returns the number of bytes used or 0 if truncated/invalid
+    static inline uint8_t GetVarint(const uint8_t * pBuffer, size_t pLength, uint32_t & pValue)
+    {
+        uint32_t value = 0;
+
+        for (uint8_t i = 0; (i < DS3231_LOG_VARINT_MAX) && (i < pLength); i++)
+        {
+            value |= (uint32_t)(pBuffer[i] & 0x7F) << (7 * i);
+
+            if (!(pBuffer[i] & 0x80))
+            {
+                pValue = value;
+                return i + 1;
+            }
+        }
+
+        return 0;
+    }
+
+    // Encode a sync record into pBuffer, returns DS3231_LOG_SYNC_SIZE
+    static inline uint8_t PutSync(uint8_t * pBuffer, uint32_t pSeconds, int16_t pTemperature)
+    {
+        pBuffer[0] = DS3231_LOG_SYNC;
+        pBuffer[1] = (uint8_t)pSeconds;
+        pBuffer[2] = (uint8_t)(pSeconds >> 8);
+        pBuffer[3] = (uint8_t)(pSeconds >> 16);
+        pBuffer[4] = (uint8_t)(pSeconds >> 24);
+        pBuffer[5] = (uint8_t)pTemperature;
+        pBuffer[6] = (uint8_t)((uint16_t)pTemperature >> 8);
+
+        return DS3231_LOG_SYNC_SIZE;
+    }
+};
+
+class DS3231LogReaderClass
+{
+public:
+    DS3231LogReaderClass(const uint8_t * pData, size_t pLength)
+        : mData(pData), mEnd(pData + pLength), mSynced(false), mError(false), mSeconds(0), mTemperature(0)
+    {
+    }
+
+    // Decode the next sample. Returns false at the end of the log or on a corrupt record
+    inline bool Next(uint32_t & pSeconds, int16_t & pTemperature)
+    {
+        uint32_t delta;
+        uint32_t temperature;
+        uint8_t length;
+
+        if (mData >= mEnd)
+        {
+            return false;
+        }
+
+        if (*mData == DS3231_LOG_SYNC)
+        {
+            if ((size_t)(mEnd - mData) < DS3231_LOG_SYNC_SIZE)
+            {
+                return fail();
+            }
+
+            mSeconds = (uint32_t)mData[1] | ((uint32_t)mData[2] << 8) | ((uint32_t)mData[3] << 16) | ((uint32_t)mData[4] << 24);
+            mTemperature = (int16_t)((uint16_t)mData[5] | ((uint16_t)mData[6] << 8));
+            mData += DS3231_LOG_SYNC_SIZE;
+            mSynced = true;
+        }
+        else
+        {
+            if (!mSynced)
+            {
+                return fail();
+            }
+
+            length = DS3231LogFormat::GetVarint(mData, mEnd - mData, delta);
+            if (length == 0)
+            {
+                return fail();
+            }
+            mData += length;
+
+            length = DS3231LogFormat::GetVarint(mData, mEnd - mData, temperature);
+            if (length == 0)
+            {
+                return fail();
+            }
+            mData += length;
+
+            mSeconds += DS3231LogFormat::UnZigZag(delta - 1);
+            mTemperature += DS3231LogFormat::UnZigZag(temperature);
+        }
+
+        pSeconds = mSeconds;
+        pTemperature = mTemperature;
+
+        return true;
+    }
+
+    bool IsError(void) const { return mError; } // True if Next() stopped before the end of the log
+    size_t Remaining(void) const { return mEnd - mData; }
+
+private:
+    inline bool fail(void)
+    {
+        mError = true;
+        return false;
+    }
+
+    const uint8_t * mData;
+    const uint8_t * mEnd;
+    bool mSynced;
+    bool mError;
+    uint32_t mSeconds;
+    int16_t mTemperature;
+};
+
+#endif
@@ -0,0 +1,256 @@
+#include "DS3231Redundant.h"
+
+DS3231RedundantClass::DS3231RedundantClass(void)
+    : mCount(0), mMuxAddress(DS3231_MUX_ADDRESS), mValid(false), mSeconds(0)
+{
+    memset(mClocks, 0, sizeof(mClocks));
+}
+
+bool DS3231RedundantClass::Begin(const uint8_t * pChannels, uint8_t pCount, uint8_t pMuxAddress)
+{
+    if ((pCount == 0) || (pCount > DS3231_REDUNDANT_MAX))
+    {
+        return false;
+    }
+
+    mCount = pCount;
+    mMuxAddress = pMuxAddress;
+    mValid = false;
+
+    for (uint8_t i = 0; i < mCount; i++)
+    {
+        memset(&mClocks[i], 0, sizeof(mClocks[i]));
+        mClocks[i].Channel = pChannels[i] & 0x07;
+    }
+
+    return DS3231Bus.Begin();
+}
+
+bool DS3231RedundantClass::Read(void)
+{
+    uint32_t healthy[DS3231_REDUNDANT_MAX];
+    uint8_t count = 0;
+    uint8_t agree = 0;
+    uint32_t value;
+    uint8_t j;
+
+    // Back to back so the clocks are sampled as close together as the bus allows
+    for (uint8_t i = 0; i < mCount; i++)
+    {
+        readClock(mClocks[i]);
+    }
+
+    for (uint8_t i = 0; i < mCount; i++)
+    {
+        if (mClocks[i].Faults != 0)
+        {
+            continue;
+        }
+
+        // Insertion sort, there are at most DS3231_REDUNDANT_MAX values
+        value = mClocks[i].Seconds;
+        for (j = count; (j > 0) && (healthy[j - 1] > value); j--)
+        {
+            healthy[j] = healthy[j - 1];
+        }
+        healthy[j] = value;
+        count++;
+    }
+
+    if (count == 0)
+    {
+        mValid = false;
+        return false;
+    }
+
+    mSeconds = healthy[(count - 1) / 2];
+
+    for (uint8_t i = 0; i < mCount; i++)
+    {
+        mClocks[i].Offset = (int32_t)(mClocks[i].Seconds - mSeconds);
+
+        if (mClocks[i].Faults != 0)
+        {
+            continue;
+        }
+
+        if ((mClocks[i].Offset > DS3231_REDUNDANT_MAX_OFFSET) || (mClocks[i].Offset < -DS3231_REDUNDANT_MAX_OFFSET))
+        {
+            mClocks[i].Faults |= DS3231_FAULT_DRIFT;
+        }
+        else
+        {
+            agree++;
+        }
+    }
+
+    mValid = (2 * agree > count);
+
+    return mValid;
+}
+
+bool DS3231RedundantClass::GetDateTime(sDateTime & pDateTime)
+{
+    if (!Read())
+    {
+        return false;
+    }
+
+    CalendarHelperClass::ConvertToDateTime(pDateTime, mSeconds);
+
+    return true;
+}
+
+uint8_t DS3231RedundantClass::Resync(void)
+{
+    DS3231Class clock;
+    sDateTime datetime;
+    uint32_t seconds;
+    uint8_t reference;
+    uint8_t count = 0;
+
+    // The time of an earlier Read() is stale by now, and its phase within the second unknown
+    if (!Read())
+    {
+        return 0;
+    }
+
+    // The voted time is the median, one of the healthy clocks has it
+    for (reference = 0; (reference < mCount) && ((mClocks[reference].Faults != 0) || (mClocks[reference].Offset != 0)); reference++)
+    {
+    }
+
+    if ((reference == mCount) || !waitSecond(reference, seconds))
+    {
+        return 0;
+    }
+
+    CalendarHelperClass::ConvertToDateTime(datetime, seconds);
+
+    for (uint8_t i = 0; i < mCount; i++)
+    {
+        if (!(mClocks[i].Faults & (DS3231_FAULT_DRIFT | DS3231_FAULT_STOPPED | DS3231_FAULT_INVALID)) ||
+            (mClocks[i].Faults & DS3231_FAULT_BUS) || !Select(i))
+        {
+            continue;
+        }
+
+        clock.SetDateTime(datetime);
+        clock.ClearOscillatorStopped();
+
+        mClocks[i].Seconds = seconds;
+        mClocks[i].Offset = 0;
+        mClocks[i].Faults = 0;
+        count++;
+    }
+
+    return count;
+}
+
+bool DS3231RedundantClass::Select(uint8_t pIndex)
+{
+    uint8_t mask;
+
+    if (pIndex >= mCount)
+    {
+        return false;
+    }
+
+    mask = 1 << mClocks[pIndex].Channel;
+
+    return DS3231Bus.Write(mMuxAddress, NULL, 0, &mask, 1);
+}
+
+uint8_t DS3231RedundantClass::GetFaults(void)
+{
+    uint8_t faults = 0;
+
+    for (uint8_t i = 0; i < mCount; i++)
+    {
+        faults |= mClocks[i].Faults;
+    }
+
+    return faults;
+}
+
+void DS3231RedundantClass::readClock(sDS3231RedundantClock & pClock)
+{
+    uint8_t values[DS3231_REDUNDANT_READ_SIZE];
+    uint8_t mask = 1 << pClock.Channel;
+    const uint8_t * time = &values[DS3231_REDUNDANT_READ_SIZE - 7];
+    sDateTime datetime;
+
+    pClock.Faults = 0;
+
+    if (!DS3231Bus.Write(mMuxAddress, NULL, 0, &mask, 1) || !DS3231Registers::Read(DS3231_REG_STATUS, values, DS3231_REDUNDANT_READ_SIZE))
+    {
+        pClock.Faults = DS3231_FAULT_BUS;
+        return;
+    }
+
+    if (values[0] & DS3231_STATUS_OSF)
+    {
+        pClock.Faults |= DS3231_FAULT_STOPPED;
+    }
+
+    pClock.Temperature = (int16_t)(((uint16_t)values[DS3231_REG_TEMPERATURE - DS3231_REG_STATUS] << 8) |
+        values[DS3231_REG_TEMPERATURE - DS3231_REG_STATUS + 1]) >> 6;
+
+    if (!isValid(time))
+    {
+        pClock.Faults |= DS3231_FAULT_INVALID;
+        return;
+    }
+
+    DS3231TimeClass::DecodeDateTime(datetime, time);
+    CalendarHelperClass::ConvertToSeconds(pClock.Seconds, datetime);
+}
+
+bool DS3231RedundantClass::waitSecond(uint8_t pIndex, uint32_t & pSeconds)
+{
+    uint8_t first;
+    uint8_t second;
+    uint8_t last;
+
+    if (!Select(pIndex) || !DS3231Registers::Read(DS3231_REG_TIME, &first, 1))
+    {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < DS3231_REDUNDANT_POLL_LIMIT; i++)
+    {
+        if (!DS3231Registers::Read(DS3231_REG_TIME, &second, 1))
+        {
+            return false;
+        }
+
+        if (second != first)
+        {
+            // Well under a minute since the clock was read, so its seconds register tells the time
+            last = mClocks[pIndex].Seconds % 60;
+            second = (second >> 4) * 10 + (second & 0x0F);
+            pSeconds = mClocks[pIndex].Seconds - last + second + ((second < last) ? 60 : 0);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DS3231RedundantClass::isValid(const uint8_t * pTime)
+{
+    // Upper limits of the time registers in BCD, 24 hour mode and no century bit
+    static const uint8_t maximum[7] = { 0x59, 0x59, 0x23, 0x07, 0x31, 0x12, 0x99 };
+    static const uint8_t minimum[7] = { 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00 };
+
+    for (uint8_t i = 0; i < 7; i++)
+    {
+        if (((pTime[i] & 0x0F) > 9) || (pTime[i] > maximum[i]) || (pTime[i] < minimum[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
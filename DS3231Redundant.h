@@ -0,0 +1,87 @@
+/*
+DS3231Redundant.h - Fault tolerant time from several DS3231 Real-Time Clocks
+
+Two or three DS3231 share address 0x68, so they sit on separate channels of a
+TCA9548A I2C multiplexer. Read() costs two transactions per clock: one byte
+to select the channel, and one read of DS3231_REDUNDANT_READ_SIZE bytes from
+the status register on. The register pointer wraps from 0x12 to 0x00, so that
+read returns status, aging, temperature and the time in one go.
+
+The time is the median of the clocks that answered with a valid time and no
+oscillator stop flag. A clock further than DS3231_REDUNDANT_MAX_OFFSET seconds
+from it is flagged as drifting; Resync() sets drifting, stopped and invalid
+clocks to the voted time. It votes again first and writes on the next second
+edge of a healthy clock, which also restarts the countdown chain of the clocks
+written, so they tick in phase with it.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Redundant_h
+#define _DS3231Redundant_h
+
+#include "DS3231.h"
+
+#define DS3231_MUX_ADDRESS          (0x70)
+#define DS3231_REDUNDANT_MAX        (3)
+#define DS3231_REDUNDANT_READ_SIZE  (0x13 - DS3231_REG_STATUS + 7) // Status to temperature, then the time registers
+#define DS3231_REDUNDANT_MAX_OFFSET (2)     // Seconds, reads of one Read() can straddle a second boundary
+#define DS3231_REDUNDANT_POLL_LIMIT (20000) // Seconds register reads while waiting for a second edge, over a second at 400kHz
+
+#define DS3231_FAULT_BUS            (0b00000001) // No answer
+#define DS3231_FAULT_STOPPED        (0b00000010) // Oscillator stop flag set, time is not valid
+#define DS3231_FAULT_INVALID        (0b00000100) // Time registers out of range
+#define DS3231_FAULT_DRIFT          (0b00001000) // Too far from the voted time
+
+struct sDS3231RedundantClock
+{
+    uint8_t Channel;        // Multiplexer channel, 0 to 7
+    uint8_t Faults;         // DS3231_FAULT_* of the last Read()
+    uint32_t Seconds;       // Time read, seconds since Jan 1st of 2000
+    int32_t Offset;         // Seconds ahead of the voted time
+    int16_t Temperature;    // Quarters of a degree Celsius
+};
+
+class DS3231RedundantClass
+{
+public:
+    DS3231RedundantClass(void);
+
+    bool Begin(const uint8_t * pChannels, uint8_t pCount, uint8_t pMuxAddress = DS3231_MUX_ADDRESS); // False if pCount is out of range
+
+    bool Read(void); // Read all clocks and vote, false if no majority of the healthy clocks agrees
+    bool GetDateTime(sDateTime & pDateTime); // Read() and return the voted time
+    uint32_t GetSeconds(void) { return mSeconds; } // Voted time of the last Read()
+
+    uint8_t Resync(void); // Vote again and set drifting, stopped and invalid clocks to the voted time, returns how many were set
+
+    bool Select(uint8_t pIndex); // Route the bus to clock pIndex, e.g. to use a DS3231Class on it
+    uint8_t GetCount(void) { return mCount; }
+    sDS3231RedundantClock & GetClock(uint8_t pIndex) { return mClocks[pIndex]; }
+    uint8_t GetFaults(void); // DS3231_FAULT_* of all clocks or'ed together
+
+private:
+    static bool isValid(const uint8_t * pTime);
+    void readClock(sDS3231RedundantClock & pClock);
+    bool waitSecond(uint8_t pIndex, uint32_t & pSeconds);
+
+    sDS3231RedundantClock mClocks[DS3231_REDUNDANT_MAX];
+    uint8_t mCount;
+    uint8_t mMuxAddress;
+    bool mValid;
+    uint32_t mSeconds;
+};
+
+#endif
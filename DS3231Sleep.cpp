@@ -0,0 +1,248 @@
+#include "DS3231Sleep.h"
+
+#if defined(ARDUINO) && defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+DS3231SleepClass::DS3231SleepClass(void)
+    :
+#if defined(ARDUINO)
+      mDS3231(NULL), mPin(0), mAwakeStart(0),
+#endif
+      mWakes(0), mAwakeMillis(0), mAsleepSeconds(0)
+{
+}
+
+#if defined(ARDUINO)
+
+static volatile uint8_t sWakePin;
+
+static void DS3231SleepWake(void)
+{
+    // INT stays low until the alarm flag is cleared, the low level interrupt would fire again at once
+    detachInterrupt(digitalPinToInterrupt(sWakePin));
+}
+
+bool DS3231SleepClass::Begin(DS3231Class & pDS3231, uint8_t pPin)
+{
+    if (digitalPinToInterrupt(pPin) < 0)
+    {
+        return false;
+    }
+
+    mDS3231 = &pDS3231;
+    mPin = pPin;
+
+    // SetBattery() also clears INTCN, so it goes before EnableOutput()
+    mDS3231->SetBattery(true, false);
+    mDS3231->EnableOutput(false);
+    mDS3231->Enable32kHz(false);
+    mDS3231->ArmAlarm2(false);
+    mDS3231->ClearAlarm1();
+
+    pinMode(mPin, INPUT_PULLUP);
+
+    mWakes = 0;
+    mAwakeMillis = 0;
+    mAsleepSeconds = 0;
+    mAwakeStart = millis();
+
+    return true;
+}
+
+bool DS3231SleepClass::Sleep(DS3231CronClass & pCron)
+{
+    sDateTime datetime;
+
+    mDS3231->GetDateTime(datetime);
+
+    if (!pCron.Next(datetime))
+    {
+        return false;
+    }
+
+    return SleepUntil(datetime);
+}
+
+bool DS3231SleepClass::SleepUntil(sDateTime & pDateTime)
+{
+    sDateTime datetime;
+    uint32_t target;
+    uint32_t now;
+
+    CalendarHelperClass::ConvertToSeconds(target, pDateTime);
+
+    mDS3231->GetDateTime(datetime);
+    CalendarHelperClass::ConvertToSeconds(now, datetime);
+
+    // Alarm 1 matches the day of the month only, an earlier month with that day wakes too early
+    while (now < target)
+    {
+        mDS3231->SetAlarm1(pDateTime.Day, pDateTime.Hour, pDateTime.Minute, pDateTime.Second, DS3231_MATCH_DT_H_M_S);
+
+        // The target can pass while the alarm is written, it would then only match next month
+        mDS3231->GetDateTime(datetime);
+        CalendarHelperClass::ConvertToSeconds(now, datetime);
+
+        if (now < target)
+        {
+            now = sleep();
+        }
+    }
+
+    return true;
+}
+
+bool DS3231SleepClass::SleepFor(uint32_t pSeconds)
+{
+    sDateTime datetime;
+    uint32_t seconds;
+
+    mDS3231->GetDateTime(datetime);
+    CalendarHelperClass::ConvertToSeconds(seconds, datetime);
+    CalendarHelperClass::ConvertToDateTime(datetime, seconds + pSeconds);
+
+    return SleepUntil(datetime);
+}
+
+uint32_t DS3231SleepClass::sleep(void)
+{
+    sDateTime datetime;
+    uint32_t before;
+    uint32_t after;
+
+    mAwakeMillis += millis() - mAwakeStart;
+
+    mDS3231->GetDateTime(datetime);
+    CalendarHelperClass::ConvertToSeconds(before, datetime);
+
+    powerDown();
+
+    mDS3231->ClearAlarm1();
+    mAwakeStart = millis();
+
+    mDS3231->GetDateTime(datetime);
+    CalendarHelperClass::ConvertToSeconds(after, datetime);
+
+    mAsleepSeconds += after - before;
+    mWakes++;
+
+    return after;
+}
+
+void DS3231SleepClass::powerDown(void)
+{
+#if defined(__AVR__)
+    uint8_t adc = ADCSRA;
+
+    ADCSRA &= ~_BV(ADEN);
+
+    sWakePin = mPin;
+    noInterrupts();
+
+    // An alarm that fired already leaves INT low, no edge would wake the MCU
+    if (digitalRead(mPin) == HIGH)
+    {
+        attachInterrupt(digitalPinToInterrupt(mPin), DS3231SleepWake, LOW);
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        sleep_enable();
+#if defined(sleep_bod_disable)
+        sleep_bod_disable();
+#endif
+        // The instruction after sei() runs before any interrupt, there is no window to miss the wake
+        interrupts();
+        sleep_cpu();
+        sleep_disable();
+    }
+
+    interrupts();
+    ADCSRA = adc;
+#else
+    while (digitalRead(mPin) == HIGH)
+    {
+        yield();
+    }
+#endif
+}
+
+#endif
+
+uint32_t DS3231SleepClass::GetAwakeMillis(void)
+{
+#if defined(ARDUINO)
+    return mAwakeMillis + (millis() - mAwakeStart);
+#else
+    return mAwakeMillis;
+#endif
+}
+
+uint16_t DS3231SleepClass::GetDutyCycle(void)
+{
+    uint32_t awake = GetAwakeMillis();
+    uint32_t total = mAsleepSeconds + awake / 1000;
+
+    if (total == 0)
+    {
+        return 10000;
+    }
+
+    return (uint64_t)awake * 10 / total;
+}
+
+void DS3231SleepClass::Project(DS3231CronClass & pCron, sDateTime & pStart, uint32_t pSeconds, uint32_t pAwakeMillis, sDS3231SleepProjection & pProjection)
+{
+    sDateTime datetime = pStart;
+    uint32_t start;
+    uint32_t fire;
+    uint64_t clock;
+    uint64_t end;
+    bool found;
+
+    pProjection.Wakes = 0;
+    pProjection.Missed = 0;
+    pProjection.AwakeMillis = 0;
+    pProjection.AsleepMillis = 0;
+
+    CalendarHelperClass::ConvertToSeconds(start, pStart);
+    clock = (uint64_t)start * 1000;
+    end = clock + (uint64_t)pSeconds * 1000;
+
+    found = pCron.Next(datetime);
+
+    while (found)
+    {
+        CalendarHelperClass::ConvertToSeconds(fire, datetime);
+
+        if ((uint64_t)fire * 1000 >= end)
+        {
+            break;
+        }
+
+        // Asleep until the alarm, then awake for pAwakeMillis
+        pProjection.AsleepMillis += (uint64_t)fire * 1000 - clock;
+        pProjection.Wakes++;
+
+        clock = (uint64_t)fire * 1000 + pAwakeMillis;
+        if (clock > end)
+        {
+            clock = end;
+        }
+        pProjection.AwakeMillis += clock - (uint64_t)fire * 1000;
+
+        // The alarm is armed again after the work, for the first fire time after
+        // the current second. Fire times up to then are lost.
+        while ((found = pCron.Next(datetime)))
+        {
+            CalendarHelperClass::ConvertToSeconds(fire, datetime);
+
+            if (fire > clock / 1000)
+            {
+                break;
+            }
+
+            pProjection.Missed++;
+        }
+    }
+
+    pProjection.AsleepMillis += end - clock;
+}
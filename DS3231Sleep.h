@@ -0,0 +1,82 @@
+/*
+DS3231Sleep.h - Sleep the MCU between alarms of the DS3231 Real-Time Clock
+
+Replaces delay() polling loops: each Sleep() programs alarm 1 with the next
+fire time of a cron schedule (or a given time), turns the RTC's INT/SQW pin
+into the alarm interrupt, switches the 32kHz and battery-backed square wave
+outputs off and puts the MCU into its deepest sleep until INT goes low. On AVR
+that is power-down with the ADC and brown-out detector off; other cores wait
+for the pin without sleeping. Alarm 1 only matches the day of the month, so a
+fire time more than a month ahead can match early; Sleep() then arms the same
+fire time again and goes back to sleep until it is reached.
+
+Time awake is counted with millis(), which stops in power-down, and time
+asleep with the RTC. Project() runs the same schedule in simulated time, on
+the host too, to estimate the duty cycle before deploying.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Sleep_h
+#define _DS3231Sleep_h
+
+#include "DS3231.h"
+#include "DS3231Cron.h"
+
+struct sDS3231SleepProjection
+{
+    uint32_t Wakes;
+    uint32_t Missed;        // Fire times that passed while awake
+    uint64_t AwakeMillis;
+    uint64_t AsleepMillis;
+};
+
+class DS3231SleepClass
+{
+public:
+    DS3231SleepClass(void);
+
+#if defined(ARDUINO)
+    bool Begin(DS3231Class & pDS3231, uint8_t pPin); // pPin is connected to INT/SQW, false if it has no interrupt
+
+    bool Sleep(DS3231CronClass & pCron); // Sleep until the next fire time of pCron, false if there is none
+    bool SleepUntil(sDateTime & pDateTime); // Sleep until pDateTime, returns at once if it has passed
+    bool SleepFor(uint32_t pSeconds);
+#endif
+
+    uint32_t GetWakes(void) { return mWakes; }
+    uint32_t GetAwakeMillis(void); // Including the current awake period
+    uint32_t GetAsleepSeconds(void) { return mAsleepSeconds; }
+    uint16_t GetDutyCycle(void); // Awake share in 1/10000
+
+    // Run pCron from pStart for pSeconds, each wake staying awake for pAwakeMillis
+    static void Project(DS3231CronClass & pCron, sDateTime & pStart, uint32_t pSeconds, uint32_t pAwakeMillis, sDS3231SleepProjection & pProjection);
+
+private:
+#if defined(ARDUINO)
+    uint32_t sleep(void); // Seconds since Jan 1st of 2000 at the wake
+    void powerDown(void);
+
+    DS3231Class * mDS3231;
+    uint8_t mPin;
+    unsigned long mAwakeStart;
+#endif
+
+    uint32_t mWakes;
+    uint32_t mAwakeMillis;
+    uint32_t mAsleepSeconds;
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "DS3231Sync.h"
+
+#define DS3231_SYNC_MAX_OFFSET      ((DS3231_SYNC_MAX_SECONDS - 1) * 1000L)
+
+DS3231SyncClass::DS3231SyncClass(DS3231Class & pDS3231, Stream & pStream)
+    : mDS3231(pDS3231), mStream(pStream), mEdgeSeconds(0), mEdgeMillis(0),
+      mOffset(0), mDelay(0), mStepped(false), mTrimValid(false), mTrimSeconds(0), mTrimResidual(0)
+{
+}
+
+bool DS3231SyncClass::Synchronize(void)
+{
+    int32_t offset;
+    uint16_t roundtrip;
+    int32_t correction;
+    sSyncStamp stamp;
+    sSyncStamp host;
+    sDateTime datetime;
+    uint32_t hostSeconds = 0;
+    bool found = false;
+
+    alignToSecond();
+
+    // Keep the exchange with the lowest round trip, its offset has the smallest error bound
+    for (uint8_t i = 0; i < DS3231_SYNC_EXCHANGES; i++)
+    {
+        if (exchange(offset, roundtrip, host) && (!found || (roundtrip < mDelay)))
+        {
+            mOffset = offset;
+            mDelay = roundtrip;
+            hostSeconds = host.Seconds;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        return false;
+    }
+
+    // Too far off to express in milliseconds, set the host's second and let the
+    // next synchronisation take care of the phase
+    if ((mOffset >= DS3231_SYNC_MAX_OFFSET) || (mOffset <= -DS3231_SYNC_MAX_OFFSET))
+    {
+        CalendarHelperClass::ConvertToDateTime(datetime, hostSeconds);
+        mDS3231.SetDateTime(datetime);
+        mStepped = true;
+        mTrimValid = false;
+        return true;
+    }
+
+    now(stamp);
+
+    if ((mOffset >= DS3231_SYNC_STEP_THRESHOLD) || (mOffset <= -DS3231_SYNC_STEP_THRESHOLD))
+    {
+        correction = mOffset;
+        mStepped = true;
+        mTrimValid = false;
+    }
+    else
+    {
+        if ((mOffset >= DS3231_SYNC_MIN_CORRECTION) || (mOffset <= -DS3231_SYNC_MIN_CORRECTION))
+        {
+            correction = clamp(mOffset, -DS3231_SYNC_MAX_STEP, DS3231_SYNC_MAX_STEP);
+        }
+        else
+        {
+            correction = 0;
+        }
+
+        mStepped = false;
+        trim(stamp.Seconds, mOffset);
+        mTrimResidual -= correction;
+    }
+
+    if (correction != 0)
+    {
+        correct(correction);
+    }
+
+    return true;
+}
+
+void DS3231SyncClass::alignToSecond(void)
+{
+    sDateTime datetime;
+    uint8_t second;
+    unsigned long start;
+
+    mDS3231.GetDateTime(datetime);
+    second = datetime.Second;
+    start = millis();
+
+    do
+    {
+        mDS3231.GetDateTime(datetime);
+    } while ((datetime.Second == second) && (millis() - start < 1100));
+
+    mEdgeMillis = millis();
+    CalendarHelperClass::ConvertToSeconds(mEdgeSeconds, datetime);
+}
+
+void DS3231SyncClass::now(sSyncStamp & pStamp)
+{
+    unsigned long elapsed = millis() - mEdgeMillis;
+
+    pStamp.Seconds = mEdgeSeconds + elapsed / 1000;
+    pStamp.Millis = elapsed % 1000;
+}
+
+bool DS3231SyncClass::exchange(int32_t & pOffset, uint16_t & pDelay, sSyncStamp & pHost)
+{
+    uint8_t request[DS3231_SYNC_REQUEST_SIZE];
+    uint8_t reply[DS3231_SYNC_REPLY_SIZE];
+    sSyncStamp t1, t2, t3, t4;
+    int32_t roundtrip;
+
+    while (mStream.available())
+    {
+        mStream.read();
+    }
+
+    request[0] = DS3231_SYNC_HEADER_0;
+    request[1] = DS3231_SYNC_HEADER_1;
+
+    now(t1);
+    DS3231SyncFormat::PutStamp(&request[2], t1);
+    mStream.write(request, DS3231_SYNC_REQUEST_SIZE);
+
+    mStream.setTimeout(DS3231_SYNC_TIMEOUT);
+    if (mStream.readBytes(reply, DS3231_SYNC_REPLY_SIZE) != DS3231_SYNC_REPLY_SIZE)
+    {
+        return false;
+    }
+    now(t4);
+
+    // A reply to an earlier, timed out request does not echo this t1
+    if ((reply[0] != DS3231_SYNC_HEADER_0) || (reply[1] != DS3231_SYNC_HEADER_1) ||
+        (memcmp(&reply[2], &request[2], DS3231_SYNC_STAMP_SIZE) != 0))
+    {
+        return false;
+    }
+
+    DS3231SyncFormat::GetStamp(t2, &reply[2 + DS3231_SYNC_STAMP_SIZE]);
+    DS3231SyncFormat::GetStamp(t3, &reply[2 + 2 * DS3231_SYNC_STAMP_SIZE]);
+
+    pOffset = DS3231SyncFormat::Difference(t2, t1) / 2 + DS3231SyncFormat::Difference(t3, t4) / 2;
+
+    roundtrip = DS3231SyncFormat::Difference(t4, t1) - DS3231SyncFormat::Difference(t3, t2);
+    pDelay = clamp(roundtrip, 0, 0xFFFF);
+    pHost = t3;
+
+    return true;
+}
+
+void DS3231SyncClass::correct(int32_t pCorrection)
+{
+    sSyncStamp stamp;
+    sDateTime datetime;
+    int32_t seconds = pCorrection / 1000;
+    int16_t fraction = pCorrection % 1000;
+
+    if (fraction < 0)
+    {
+        fraction += 1000;
+        seconds--;
+    }
+
+    now(stamp);
+
+    // The corrected clock now reads stamp + seconds + fraction. Wait for its next
+    // second boundary and write it then, the write restarts the RTC's countdown
+    // chain so the new second starts exactly on that boundary.
+    fraction += stamp.Millis;
+    seconds += fraction / 1000 + 1;
+
+    delay(1000 - fraction % 1000);
+
+    CalendarHelperClass::ConvertToDateTime(datetime, stamp.Seconds + seconds);
+    mDS3231.SetDateTime(datetime);
+
+    mEdgeMillis = millis();
+    mEdgeSeconds = stamp.Seconds + seconds;
+}
+
+void DS3231SyncClass::trim(uint32_t pSeconds, int32_t pOffset)
+{
+    uint32_t elapsed;
+    int32_t drift;
+    int32_t step;
+
+    if (!mTrimValid)
+    {
+        mTrimValid = true;
+        mTrimSeconds = pSeconds;
+        mTrimResidual = pOffset;
+        return;
+    }
+
+    elapsed = pSeconds - mTrimSeconds;
+    if (elapsed < DS3231_SYNC_TRIM_INTERVAL)
+    {
+        return;
+    }
+
+    // Offset gained since the last trim. Positive means the RTC runs slow and
+    // the aging register, one step per ~0.1ppm, has to go down.
+    drift = clamp(pOffset - mTrimResidual, -100000L, 100000L);
+    step = drift * 10000L / (int32_t)elapsed;
+    step = clamp(step, -DS3231_SYNC_MAX_AGING_STEP, DS3231_SYNC_MAX_AGING_STEP);
+
+    if (step != 0)
+    {
+        // The new value is used from the next temperature conversion on
+        mDS3231.SetAging(clamp(mDS3231.GetAging() - step, -128, 127));
+    }
+
+    mTrimSeconds = pSeconds;
+    mTrimResidual = pOffset;
+}
+
+int32_t DS3231SyncClass::clamp(int32_t pValue, int32_t pLow, int32_t pHigh)
+{
+    return (pValue < pLow) ? pLow : ((pValue > pHigh) ? pHigh : pValue);
+}
@@ -0,0 +1,86 @@
+/*
+DS3231Sync.h - Host clock synchronisation for the DS3231 Real-Time Clock
+
+Exchanges NTP-style timestamps with a host over any Stream (see
+extras/DS3231SyncHost, frames in DS3231SyncFormat.h) and corrects the RTC:
+
+ - offsets below the step threshold are corrected in steps of at most
+   DS3231_SYNC_MAX_STEP per Synchronize(). Each step rewrites the time exactly
+   on a second boundary of the corrected clock, so the second it lands in is
+   shorter or longer but none is skipped or repeated;
+ - the frequency error measured between synchronisations is trimmed through
+   the aging register;
+ - offsets above the step threshold are corrected in one step.
+
+Outside Arduino, Stream, millis() and delay() have to be declared before this
+header. extras/DS3231SyncDevice does that with its DS3231SyncShim.h to run the
+class on the host against a simulated RTC, talking to DS3231SyncHost over a
+pseudo terminal.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Sync_h
+#define _DS3231Sync_h
+
+#include "DS3231.h"
+#include "DS3231SyncFormat.h"
+
+#define DS3231_SYNC_EXCHANGES       (4)         // Exchanges per Synchronize(), the one with the lowest delay is used
+#define DS3231_SYNC_TIMEOUT         (500)       // ms to wait for a reply
+#define DS3231_SYNC_STEP_THRESHOLD  (10000L)    // ms, larger offsets are corrected in one step
+#define DS3231_SYNC_MAX_STEP        (500)       // ms corrected per Synchronize() below the step threshold
+#define DS3231_SYNC_MIN_CORRECTION  (5)         // ms, smaller offsets are left to the aging trim
+#ifndef DS3231_SYNC_TRIM_INTERVAL
+#define DS3231_SYNC_TRIM_INTERVAL   (3600UL)    // s between synchronisations needed to estimate the frequency error
+#endif
+#define DS3231_SYNC_MAX_AGING_STEP  (10)        // Aging register change per trim
+
+class DS3231SyncClass
+{
+public:
+    DS3231SyncClass(DS3231Class & pDS3231, Stream & pStream);
+
+    bool Synchronize(void); // Measure the offset to the host and correct the RTC. False if the host did not answer
+
+    int32_t GetOffset(void) { return mOffset; }     // Host minus RTC in ms, as last measured
+    uint16_t GetDelay(void) { return mDelay; }      // Round trip delay in ms, as last measured
+    bool IsStepped(void) { return mStepped; }       // True if the last correction took the whole offset in one step
+
+private:
+    void alignToSecond(void);
+    void now(sSyncStamp & pStamp);
+    bool exchange(int32_t & pOffset, uint16_t & pDelay, sSyncStamp & pHost);
+    void correct(int32_t pCorrection);
+    void trim(uint32_t pSeconds, int32_t pOffset);
+
+    static int32_t clamp(int32_t pValue, int32_t pLow, int32_t pHigh);
+
+    DS3231Class & mDS3231;
+    Stream & mStream;
+
+    uint32_t mEdgeSeconds;      // RTC time at the last observed second boundary
+    unsigned long mEdgeMillis;  // millis() at the last observed second boundary
+
+    int32_t mOffset;
+    uint16_t mDelay;
+    bool mStepped;
+
+    bool mTrimValid;
+    uint32_t mTrimSeconds;      // RTC time of the last synchronisation
+    int32_t mTrimResidual;      // Offset left uncorrected at the last synchronisation
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*
+DS3231SyncFormat.h - Frame format of the DS3231SyncClass timestamp exchange
+
+This header has no Arduino dependencies so the host side (extras/DS3231SyncHost)
+and the device side share one definition of the frames.
+
+Frames (little endian, timestamps are seconds since 2000 plus milliseconds):
+
+    request:  'S' 'Y' t1
+    reply:    'S' 'Y' t1 t2 t3
+
+t1 is the device's time when the request is sent, echoed so a late reply to
+an earlier request is recognised. t2 is the host's time when the request was
+received and t3 its time when the reply is sent.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231SyncFormat_h
+#define _DS3231SyncFormat_h
+
+#include <stdint.h>
+
+#define DS3231_SYNC_HEADER_0        ('S')
+#define DS3231_SYNC_HEADER_1        ('Y')
+#define DS3231_SYNC_STAMP_SIZE      (6)
+#define DS3231_SYNC_REQUEST_SIZE    (2 + DS3231_SYNC_STAMP_SIZE)
+#define DS3231_SYNC_REPLY_SIZE      (2 + 3 * DS3231_SYNC_STAMP_SIZE)
+
+#define DS3231_SYNC_MAX_SECONDS     (2000000L) // Differences are saturated here to fit milliseconds in an int32_t
+
+struct sSyncStamp
+{
+    uint32_t Seconds; // Seconds since Jan 1st of 2000
+    uint16_t Millis;
+};
+
+class DS3231SyncFormat
+{
+public:
+    static inline void PutStamp(uint8_t * pBuffer, const sSyncStamp & pStamp)
+    {
+        pBuffer[0] = (uint8_t)pStamp.Seconds;
+        pBuffer[1] = (uint8_t)(pStamp.Seconds >> 8);
+        pBuffer[2] = (uint8_t)(pStamp.Seconds >> 16);
+        pBuffer[3] = (uint8_t)(pStamp.Seconds >> 24);
+        pBuffer[4] = (uint8_t)pStamp.Millis;
+        pBuffer[5] = (uint8_t)(pStamp.Millis >> 8);
+    }
+
+    static inline void GetStamp(sSyncStamp & pStamp, const uint8_t * pBuffer)
+    {
+        pStamp.Seconds = (uint32_t)pBuffer[0] | ((uint32_t)pBuffer[1] << 8) | ((uint32_t)pBuffer[2] << 16) | ((uint32_t)pBuffer[3] << 24);
+        pStamp.Millis = (uint16_t)pBuffer[4] | ((uint16_t)pBuffer[5] << 8);
+    }
+
+    // pOne minus pTwo in milliseconds, saturated at DS3231_SYNC_MAX_SECONDS
+    static inline int32_t Difference(const sSyncStamp & pOne, const sSyncStamp & pTwo)
+    {
+        int32_t seconds = (int32_t)(pOne.Seconds - pTwo.Seconds);
+
+        if (seconds > DS3231_SYNC_MAX_SECONDS)
+        {
+            seconds = DS3231_SYNC_MAX_SECONDS;
+        }
+        else if (seconds < -DS3231_SYNC_MAX_SECONDS)
+        {
+            seconds = -DS3231_SYNC_MAX_SECONDS;
+        }
+
+        return seconds * 1000 + ((int16_t)pOne.Millis - (int16_t)pTwo.Millis);
+    }
+};
+
+#endif
@@ -0,0 +1,150 @@
+#include "DS3231Temperature.h"
+
+DS3231TemperatureClass::DS3231TemperatureClass(void)
+    : mDS3231(NULL), mPending(false), mHead(0), mCount(0), mSum(0)
+{
+    memset(mValues, 0, sizeof(mValues));
+    memset(mMillis, 0, sizeof(mMillis));
+    memset(&mMin, 0, sizeof(mMin));
+    memset(&mMax, 0, sizeof(mMax));
+}
+
+void DS3231TemperatureClass::Begin(DS3231ControlClass & pDS3231)
+{
+    mDS3231 = &pDS3231;
+    mPending = false;
+    mHead = 0;
+    mCount = 0;
+    mSum = 0;
+    mMin.Count = 0;
+    mMax.Count = 0;
+}
+
+bool DS3231TemperatureClass::Update(void)
+{
+    unsigned long now = millis();
+
+    if (mDS3231 == NULL)
+    {
+        return false;
+    }
+
+    if (mPending)
+    {
+        if (mDS3231->IsConverting())
+        {
+            return false;
+        }
+
+        mPending = false;
+    }
+    else if ((mCount != 0) && (now - GetMillis() < DS3231_TEMPERATURE_PERIOD))
+    {
+        return false;
+    }
+    else if (mDS3231->GetStatus() & DS3231_STATUS_BSY)
+    {
+        // Half written by the running conversion, the next call reads it
+        return false;
+    }
+
+    add(mDS3231->GetTemperatureRaw(), now);
+
+    return true;
+}
+
+bool DS3231TemperatureClass::Convert(void)
+{
+    if ((mDS3231 == NULL) || !mDS3231->StartConversion())
+    {
+        return false;
+    }
+
+    mPending = true;
+
+    return true;
+}
+
+int16_t DS3231TemperatureClass::GetMean(void)
+{
+    if (mCount == 0)
+    {
+        return 0;
+    }
+
+    if (mSum < 0)
+    {
+        return (mSum - mCount / 2) / mCount;
+    }
+
+    return (mSum + mCount / 2) / mCount;
+}
+
+int32_t DS3231TemperatureClass::GetRate(void)
+{
+    uint8_t first = oldest();
+    uint8_t last = newest();
+    unsigned long seconds = (mMillis[last] - mMillis[first]) / 1000;
+
+    if ((mCount < 2) || (seconds == 0))
+    {
+        return 0;
+    }
+
+    return (int32_t)(mValues[last] - mValues[first]) * 3600 / (int32_t)seconds;
+}
+
+void DS3231TemperatureClass::add(int16_t pValue, unsigned long pMillis)
+{
+    if (mCount == DS3231_TEMPERATURE_HISTORY)
+    {
+        // mHead is the oldest sample, it leaves the window
+        mSum -= mValues[mHead];
+
+        if (mMin.Index[mMin.First] == mHead)
+        {
+            mMin.First = (mMin.First + 1) % DS3231_TEMPERATURE_HISTORY;
+            mMin.Count--;
+        }
+
+        if (mMax.Index[mMax.First] == mHead)
+        {
+            mMax.First = (mMax.First + 1) % DS3231_TEMPERATURE_HISTORY;
+            mMax.Count--;
+        }
+    }
+    else
+    {
+        mCount++;
+    }
+
+    mValues[mHead] = pValue;
+    mMillis[mHead] = pMillis;
+    mSum += pValue;
+
+    push(mMin, mHead, false);
+    push(mMax, mHead, true);
+
+    mHead = (mHead + 1) % DS3231_TEMPERATURE_HISTORY;
+}
+
+void DS3231TemperatureClass::push(sDS3231TemperatureQueue & pQueue, uint8_t pIndex, bool pMax)
+{
+    uint8_t last;
+
+    // Older samples that are not below (above) the new one can never be the minimum (maximum) again
+    while (pQueue.Count != 0)
+    {
+        last = pQueue.Index[(pQueue.First + pQueue.Count - 1) % DS3231_TEMPERATURE_HISTORY];
+
+        if (pMax ? (mValues[last] > mValues[pIndex]) : (mValues[last] < mValues[pIndex]))
+        {
+            break;
+        }
+
+        pQueue.Count--;
+    }
+
+    pQueue.Index[(pQueue.First + pQueue.Count) % DS3231_TEMPERATURE_HISTORY] = pIndex;
+    pQueue.Count++;
+}
@@ -0,0 +1,86 @@
+/*
+DS3231Temperature.h - Cached temperature and statistics for the DS3231 Real-Time Clock
+
+The DS3231 measures its temperature every 64 seconds (see DS3231_TEMPERATURE_PERIOD).
+Update() reads the register once per period, never while BSY is set, and keeps
+the last DS3231_TEMPERATURE_HISTORY samples. All getters work on the cached
+samples without touching the bus: min and max are kept in monotonic queues,
+the mean in a running sum, so each is O(1).
+
+Temperatures are raw quarters of a degree Celsius, print them with
+DS3231ControlClass::SPrintTemperature().
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231Temperature_h
+#define _DS3231Temperature_h
+
+#include "DS3231.h"
+
+#define DS3231_TEMPERATURE_PERIOD   (64000UL) // ms between automatic conversions
+
+#if !defined(DS3231_TEMPERATURE_HISTORY)
+#define DS3231_TEMPERATURE_HISTORY  (16) // Samples kept for the statistics, at most 255
+#endif
+
+// Ring buffer positions of the samples that can still become the minimum (or maximum)
+struct sDS3231TemperatureQueue
+{
+    uint8_t Index[DS3231_TEMPERATURE_HISTORY];
+    uint8_t First;
+    uint8_t Count;
+};
+
+class DS3231TemperatureClass
+{
+public:
+    DS3231TemperatureClass(void);
+
+    void Begin(DS3231ControlClass & pDS3231);
+
+    bool Update(void); // Call from loop(), true when a new sample was read
+    bool Convert(void); // Have the next Update() read a conversion started now, false while one is running
+
+    uint8_t GetCount(void) { return mCount; } // Samples in the statistics, 0 before the first Update()
+    int16_t GetRaw(void) { return mValues[newest()]; } // Last sample
+    unsigned long GetMillis(void) { return mMillis[newest()]; } // millis() when the last sample was read
+
+    int16_t GetMin(void) { return mValues[mMin.Index[mMin.First]]; }
+    int16_t GetMax(void) { return mValues[mMax.Index[mMax.First]]; }
+    int16_t GetMean(void); // Rounded to a quarter degree
+    int32_t GetRate(void); // Quarters of a degree per hour from the oldest to the last sample, can exceed int16_t for close samples
+
+private:
+    void add(int16_t pValue, unsigned long pMillis);
+    void push(sDS3231TemperatureQueue & pQueue, uint8_t pIndex, bool pMax);
+
+    uint8_t newest(void) { return (mHead + DS3231_TEMPERATURE_HISTORY - 1) % DS3231_TEMPERATURE_HISTORY; }
+    uint8_t oldest(void) { return (mHead + DS3231_TEMPERATURE_HISTORY - mCount) % DS3231_TEMPERATURE_HISTORY; }
+
+    DS3231ControlClass * mDS3231;
+    bool mPending;
+
+    int16_t mValues[DS3231_TEMPERATURE_HISTORY];
+    unsigned long mMillis[DS3231_TEMPERATURE_HISTORY];
+    uint8_t mHead;      // Position of the next sample
+    uint8_t mCount;
+    int32_t mSum;
+
+    sDS3231TemperatureQueue mMin;
+    sDS3231TemperatureQueue mMax;
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+  DS3231: Real-Time Clock. MCU clock calibration
+
+  Connect the DS3231 SQW pin to Arduino pin 2. Measures the MCU clock error
+  over 10 seconds and prints raw and corrected milliseconds.
+*/
+
+#include "DS3231.h"
+#include "DS3231Calibration.h"
+
+DS3231Class DS3231;
+DS3231CalibrationClass Calibration;
+
+void setup()
+{
+    Serial.begin(115200);
+
+    DS3231.Begin();
+    Calibration.Begin(DS3231, 2, DS3231_CALIBRATION_1HZ);
+
+    if (Calibration.Measure(10))
+    {
+        Serial.print("MCU clock error (ppm): ");
+        Serial.println(Calibration.GetPpm());
+    }
+    else
+    {
+        Serial.println("No edges on pin 2, check the SQW connection");
+    }
+
+    Calibration.End();
+}
+
+void loop()
+{
+    Serial.print(millis());
+    Serial.print(" ");
+    Serial.println(Calibration.Millis());
+
+    delay(1000);
+}
@@ -0,0 +1,55 @@
+/*
+  DS3231: Real-Time Clock. Cron schedule
+
+  Programs alarm 1 with the next fire time of a cron schedule and
+  re-arms it after each fire.
+*/
+
+#include "DS3231.h"
+#include "DS3231Cron.h"
+
+DS3231Class DS3231;
+DS3231CronClass Cron;
+sDateTime next;
+
+void arm(void)
+{
+    char buffer[24];
+
+    DS3231.GetDateTime(next);
+    Cron.SetAlarm1(DS3231, next);
+
+    CalendarHelperClass::SPrintTime(buffer, next);
+    Serial.print("Next: ");
+    Serial.println(buffer);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    DS3231.Begin();
+
+    // Every 15 minutes from 08:00 to 17:45, monday to friday
+    Cron.Compile("0 */15 8-17 * * 1-5");
+    arm();
+}
+
+void loop()
+{
+    sDateTime now;
+
+    if (DS3231.IsAlarm1())
+    {
+        DS3231.GetDateTime(now);
+
+        if (Cron.Matches(now))
+        {
+            Serial.println("Fired");
+        }
+
+        arm();
+    }
+
+    delay(100);
+}
@@ -0,0 +1,53 @@
+/*
+  DS3231: Real-Time Clock. EEPROM ring log
+
+  Logs the temperature to the module's AT24C32 every minute, 8 byte
+  records in the upper 2KB, and prints the log at startup.
+*/
+
+#include "DS3231.h"
+#include "DS3231Eeprom.h"
+
+DS3231Class DS3231;
+DS3231EepromClass Eeprom;
+DS3231EepromLogClass Log(Eeprom);
+
+void setup()
+{
+    char buffer[24];
+    sDateTime datetime;
+    uint32_t seconds;
+    uint8_t payload[2];
+
+    Serial.begin(115200);
+
+    DS3231.Begin();
+    Eeprom.Begin();
+    Log.Begin(2048, 2048, 8);
+
+    for (uint16_t i = 0; i < Log.GetCount(); i++)
+    {
+        if (Log.Read(i, seconds, payload))
+        {
+            CalendarHelperClass::ConvertToDateTime(datetime, seconds);
+            CalendarHelperClass::SPrintTime(buffer, datetime);
+            Serial.print(buffer);
+            Serial.print(" ");
+
+            DS3231Class::SPrintTemperature(buffer, (int16_t)((uint16_t)payload[0] | ((uint16_t)payload[1] << 8)));
+            Serial.println(buffer);
+        }
+    }
+}
+
+void loop()
+{
+    int16_t temperature = DS3231.GetTemperatureRaw();
+    uint8_t payload[2] = { (uint8_t)temperature, (uint8_t)((uint16_t)temperature >> 8) };
+
+    // Four records share a page, Flush() after each one only to survive a power loss
+    Log.Append(DS3231, payload);
+    Log.Flush();
+
+    delay(60000);
+}
@@ -0,0 +1,27 @@
+/*
+  DS3231: Real-Time Clock. Binary time and temperature log
+
+  Writes one 2-3 byte record per sample to the serial port. Capture the
+  output to a file and decode it with extras/DS3231LogDecode.
+*/
+
+#include "DS3231.h"
+#include "DS3231Log.h"
+
+DS3231Class DS3231;
+DS3231LogWriterClass LogWriter(Serial);
+
+void setup()
+{
+    Serial.begin(115200);
+
+    DS3231.Begin();
+    LogWriter.Begin();
+}
+
+void loop()
+{
+    LogWriter.Append(DS3231);
+
+    delay(10000);
+}
@@ -0,0 +1,36 @@
+/*
+  DS3231: Real-Time Clock. Minimal footprint example
+
+  Prints time and temperature without sprintf or float. It builds with
+  DS3231_NO_FLOAT defined (see DS3231Config.h), which makes sure nothing
+  calls the float GetTemperature().
+*/
+
+#include "DS3231.h"
+
+DS3231Class DS3231;
+char buffer[24];
+sDateTime datetime;
+
+void setup()
+{
+    Serial.begin(115200);
+
+    DS3231.Begin();
+}
+
+void loop()
+{
+    char * end;
+
+    DS3231.GetDateTime(datetime);
+    CalendarHelperClass::SPrintTime(buffer, datetime);
+
+    end = buffer + strlen(buffer);
+    *end++ = ' ';
+    DS3231Class::SPrintTemperature(end, DS3231.GetTemperatureRaw());
+
+    Serial.println(buffer);
+
+    delay(1000);
+}
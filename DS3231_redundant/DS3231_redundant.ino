@@ -0,0 +1,50 @@
+/*
+  DS3231: Real-Time Clock. Redundant clocks
+
+  Three DS3231 on channels 0 to 2 of a TCA9548A multiplexer at 0x70.
+  Prints the voted time and resynchronises clocks that failed.
+*/
+
+#include "DS3231.h"
+#include "DS3231Redundant.h"
+
+DS3231RedundantClass Clocks;
+
+const uint8_t channels[] = { 0, 1, 2 };
+
+void setup()
+{
+    Serial.begin(115200);
+
+    Clocks.Begin(channels, sizeof(channels));
+}
+
+void loop()
+{
+    char buffer[24];
+    sDateTime datetime;
+
+    if (Clocks.GetDateTime(datetime))
+    {
+        CalendarHelperClass::SPrintTime(buffer, datetime);
+        Serial.print(buffer);
+    }
+    else
+    {
+        Serial.print("No majority");
+    }
+
+    for (uint8_t i = 0; i < Clocks.GetCount(); i++)
+    {
+        Serial.print(" ");
+        Serial.print(Clocks.GetClock(i).Faults, HEX);
+    }
+    Serial.println();
+
+    if (Clocks.GetFaults() & (DS3231_FAULT_DRIFT | DS3231_FAULT_STOPPED | DS3231_FAULT_INVALID))
+    {
+        Clocks.Resync();
+    }
+
+    delay(1000);
+}
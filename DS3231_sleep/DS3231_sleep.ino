@@ -0,0 +1,39 @@
+/*
+  DS3231: Real-Time Clock. Sleep between alarms
+
+  Sleeps until the next fire time of a cron schedule, takes a temperature
+  sample and goes back to sleep. Connect INT/SQW to pin 2. Project the
+  battery life of a schedule with extras/DS3231SleepProjection.
+*/
+
+#include "DS3231.h"
+#include "DS3231Cron.h"
+#include "DS3231Sleep.h"
+
+DS3231Class DS3231;
+DS3231CronClass Cron;
+DS3231SleepClass Sleep;
+
+void setup()
+{
+    Serial.begin(115200);
+
+    DS3231.Begin();
+    Sleep.Begin(DS3231, 2);
+
+    // Every 15 minutes from 08:00 to 17:45, monday to friday
+    Cron.Compile("0 */15 8-17 * * 1-5");
+}
+
+void loop()
+{
+    char buffer[8];
+
+    Sleep.Sleep(Cron);
+
+    DS3231Class::SPrintTemperature(buffer, DS3231.GetTemperatureRaw());
+    Serial.print(buffer);
+    Serial.print(" duty cycle 1/10000: ");
+    Serial.println(Sleep.GetDutyCycle());
+    Serial.flush();
+}
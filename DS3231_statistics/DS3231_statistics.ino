@@ -0,0 +1,49 @@
+/*
+  DS3231: Real-Time Clock. Temperature statistics
+
+  Reads the temperature once per conversion and prints the cached
+  statistics every second without further bus traffic.
+*/
+
+#include "DS3231.h"
+#include "DS3231Temperature.h"
+
+DS3231Class DS3231;
+DS3231TemperatureClass Temperature;
+
+void print(const char * pName, int16_t pTemperature)
+{
+    char buffer[8];
+
+    DS3231Class::SPrintTemperature(buffer, pTemperature);
+
+    Serial.print(pName);
+    Serial.print(buffer);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    DS3231.Begin();
+    Temperature.Begin(DS3231);
+    Temperature.Convert();
+}
+
+void loop()
+{
+    Temperature.Update();
+
+    if (Temperature.GetCount() != 0)
+    {
+        print("Now: ", Temperature.GetRaw());
+        print(" Min: ", Temperature.GetMin());
+        print(" Max: ", Temperature.GetMax());
+        print(" Mean: ", Temperature.GetMean());
+        Serial.print(" Rate (1/4 C per h): ");
+        Serial.print(Temperature.GetRate());
+        Serial.println();
+    }
+
+    delay(1000);
+}
@@ -0,0 +1,39 @@
+/*
+  DS3232: Real-Time Clock. Battery-backed SRAM
+
+  Counts restarts in the first SRAM bytes, the count survives power loss
+  as long as the backup battery is in place.
+*/
+
+#include "DS3231.h"
+
+DS3232Class DS3232;
+
+void setup()
+{
+    uint8_t counter[4];
+    uint32_t restarts;
+
+    Serial.begin(115200);
+
+    DS3232.Begin();
+
+    DS3232.ReadSram(0, counter, sizeof(counter));
+    restarts = (uint32_t)counter[0] | ((uint32_t)counter[1] << 8) | ((uint32_t)counter[2] << 16) | ((uint32_t)counter[3] << 24);
+    restarts++;
+
+    counter[0] = (uint8_t)restarts;
+    counter[1] = (uint8_t)(restarts >> 8);
+    counter[2] = (uint8_t)(restarts >> 16);
+    counter[3] = (uint8_t)(restarts >> 24);
+    DS3232.WriteSram(0, counter, sizeof(counter));
+
+    Serial.print("Restarts: ");
+    Serial.println(restarts);
+    Serial.print("SRAM bytes: ");
+    Serial.println(DS3232.GetSramSize());
+}
+
+void loop()
+{
+}
@@ -0,0 +1,393 @@
+/*
+DS3231EepromTest.cpp - Host test of DS3231EepromClass and DS3231EepromLogClass
+
+Runs both classes against a simulated AT24C32 hooked in through
+DS3231BusClass::SetTransfer(). The simulated EEPROM wraps a write burst inside
+its page, counts write cycles and does not acknowledge its address while one
+runs. Checks that buffered writes are coalesced into one burst per run of
+written bytes, that the driver waits for write cycles by ACK polling and gives
+up after DS3231_EEPROM_POLL_LIMIT polls, that the log keeps its records in
+order across restarts and more than 256 laps of equal timestamps, and that a
+page burst cut short by a power loss only loses the records it held.
+
+Build: g++ -O2 -I../.. -o DS3231EepromTest DS3231EepromTest.cpp ../../DS3231Eeprom.cpp ../../DS3231.cpp ../../DS3231Bus.cpp ../../CalendarHelper.cpp
+Usage: DS3231EepromTest [-r seed]
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "DS3231Eeprom.h"
+
+#define SIM_CYCLE_POLLS         (3)     // Address polls not acknowledged after each burst
+#define TEST_LOG_START          (2048)
+#define TEST_RECORD_SIZE        (8)     // Two bytes of payload, a record number
+#define TEST_RECORDS_PER_PAGE   (DS3231_EEPROM_PAGE / TEST_RECORD_SIZE)
+#define TEST_REPORT_LIMIT       (10)    // Failures printed, the rest are only counted
+
+/* Simulated AT24C32 ----------------------------------------------------- */
+
+static uint8_t sMemory[DS3231_EEPROM_SIZE];
+static uint16_t sPointer;
+static uint16_t sCyclePolls = SIM_CYCLE_POLLS;
+static uint16_t sBusy;          // Polls left until the running write cycle is done
+static unsigned long sCycles;   // Write cycles started
+static unsigned long sPolls;    // Address polls not acknowledged
+static int sTear = -1;          // Byte of the next burst where the power fails, -1 for none
+
+static void SimReset(uint8_t pFill)
+{
+    memset(sMemory, pFill, sizeof(sMemory));
+    sPointer = 0;
+    sBusy = 0;
+    sCycles = 0;
+    sPolls = 0;
+    sTear = -1;
+}
+
+static void SimBurst(const uint8_t * pData, uint16_t pLength)
+{
+    uint16_t page = sPointer & ~(DS3231_EEPROM_PAGE - 1);
+
+    // The address counter wraps inside the page. Cells the write cycle did not get to have every bit wrong,
+    // which no 8 byte record cut short passes the CRC with.
+    for (uint16_t i = 0; i < pLength; i++)
+    {
+        sMemory[sPointer] = ((sTear >= 0) && (i >= sTear)) ? (uint8_t)~pData[i] : pData[i];
+        sPointer = page | ((sPointer + 1) & (DS3231_EEPROM_PAGE - 1));
+    }
+
+    sTear = -1;
+    sBusy = sCyclePolls;
+    sCycles++;
+}
+
+static int SimTransfer(int pFd, struct i2c_rdwr_ioctl_data * pData)
+{
+    (void)pFd;
+
+    if (pData->nmsgs && (pData->msgs[0].addr != DS3231_EEPROM_ADDRESS))
+    {
+        return -1;
+    }
+
+    // No acknowledge at all while a write cycle runs
+    if (sBusy)
+    {
+        sBusy--;
+        sPolls++;
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < pData->nmsgs; i++)
+    {
+        struct i2c_msg & message = pData->msgs[i];
+
+        if (message.flags & I2C_M_RD)
+        {
+            for (uint16_t j = 0; j < message.len; j++)
+            {
+                message.buf[j] = sMemory[sPointer];
+                sPointer = (sPointer + 1) % DS3231_EEPROM_SIZE;
+            }
+        }
+        else if (message.len >= 2)
+        {
+            sPointer = ((message.buf[0] << 8) | message.buf[1]) % DS3231_EEPROM_SIZE;
+
+            if (message.len > 2)
+            {
+                SimBurst(&message.buf[2], message.len - 2);
+            }
+        }
+    }
+
+    return pData->nmsgs;
+}
+
+/* Checks ---------------------------------------------------------------- */
+
+static uint64_t sRandom = 0x2545F4914F6CDD1DULL;
+static unsigned long sChecks;
+static unsigned long sFailures;
+
+static uint32_t Random(uint32_t pRange)
+{
+    sRandom ^= sRandom << 13;
+    sRandom ^= sRandom >> 7;
+    sRandom ^= sRandom << 17;
+
+    return (uint32_t)((sRandom >> 16) % pRange);
+}
+
+static void Check(const char * pCheck, long pValue, long pExpected)
+{
+    sChecks++;
+    if (pValue == pExpected)
+    {
+        return;
+    }
+
+    if (sFailures++ < TEST_REPORT_LIMIT)
+    {
+        printf("FAIL %-12s %ld, expected %ld\n", pCheck, pValue, pExpected);
+    }
+}
+
+static unsigned long Bursts(uint16_t pLength)
+{
+    return (pLength + (DS3231_BUS_MAX_LENGTH - 2) - 1) / (DS3231_BUS_MAX_LENGTH - 2);
+}
+
+static void CheckCoalescing(DS3231EepromClass & pEeprom)
+{
+    uint8_t data[DS3231_EEPROM_PAGE + 8];
+    uint8_t back[sizeof(data)];
+    bool same;
+
+    for (uint8_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = i * 7 + 1;
+    }
+
+    // A page written byte by byte goes out as one burst
+    SimReset(0xFF);
+    for (uint8_t i = 0; i < DS3231_EEPROM_PAGE; i++)
+    {
+        pEeprom.Write(64 + i, &data[i], 1);
+    }
+    Check("coalesce", sCycles, 0);
+    Check("coalesce", pEeprom.Flush(), true);
+    Check("coalesce", sCycles, Bursts(DS3231_EEPROM_PAGE));
+    Check("coalesce", memcmp(&sMemory[64], data, DS3231_EEPROM_PAGE), 0);
+
+    // Two runs in one page are two bursts, the bytes in between keep their content
+    SimReset(0xA5);
+    pEeprom.Write(128, &data[0], 4);
+    pEeprom.Write(136, &data[8], 4);
+    pEeprom.Flush();
+    Check("gap", sCycles, 2);
+    same = (memcmp(&sMemory[128], &data[0], 4) == 0) && (memcmp(&sMemory[136], &data[8], 4) == 0);
+    Check("gap", same && (sMemory[132] == 0xA5) && (sMemory[135] == 0xA5), true);
+
+    // Leaving a page bursts it, reads see the bytes still buffered
+    SimReset(0xFF);
+    pEeprom.Write(200, data, sizeof(data));
+    Check("cross", sCycles, Bursts(24));
+    Check("cross", pEeprom.Read(200, back, sizeof(back)) && (memcmp(back, data, sizeof(data)) == 0), true);
+    pEeprom.Flush();
+    Check("cross", memcmp(&sMemory[200], data, sizeof(data)), 0);
+}
+
+static void CheckPolling(DS3231EepromClass & pEeprom)
+{
+    uint8_t data[2 * DS3231_EEPROM_PAGE];
+    uint8_t back[sizeof(data)];
+
+    memset(data, 0x3C, sizeof(data));
+
+    // The second page waits for the write cycle of the first, Flush() for its own
+    SimReset(0xFF);
+    pEeprom.Write(0, data, sizeof(data));
+    Check("poll", pEeprom.Flush(), true);
+    Check("poll", sPolls, sCycles * SIM_CYCLE_POLLS);
+    Check("poll", pEeprom.Read(0, back, sizeof(back)) && (memcmp(back, data, sizeof(data)) == 0), true);
+
+    // A write cycle that never ends fails instead of hanging
+    SimReset(0xFF);
+    sCyclePolls = DS3231_EEPROM_POLL_LIMIT + 1;
+    pEeprom.Write(0, data, 1);
+    Check("poll limit", pEeprom.Flush(), false);
+    Check("poll limit", sPolls, DS3231_EEPROM_POLL_LIMIT);
+    sCyclePolls = SIM_CYCLE_POLLS;
+    pEeprom.Begin();
+}
+
+static uint16_t Number(const uint8_t * pPayload)
+{
+    return pPayload[0] | (pPayload[1] << 8);
+}
+
+static void Append(DS3231EepromLogClass & pLog, uint16_t pNumber, uint32_t pSeconds)
+{
+    uint8_t payload[2] = { (uint8_t)pNumber, (uint8_t)(pNumber >> 8) };
+
+    pLog.Append(pSeconds, payload);
+}
+
+// pRecords records at pRate per second, restarting after every pRestart. Every record survives a restart,
+// the newest is found again and Find() returns the first record of the newest second.
+static void CheckLog(DS3231EepromClass & pEeprom, uint16_t pRecords, uint16_t pRate, uint16_t pRestart, uint16_t pSize)
+{
+    DS3231EepromLogClass * log = new DS3231EepromLogClass(pEeprom);
+    uint16_t slots = pSize / TEST_RECORD_SIZE;
+    uint16_t count = (pRecords < slots) ? pRecords : slots;
+    uint16_t found;
+    uint32_t seconds;
+    uint8_t payload[2];
+    bool ordered = true;
+
+    SimReset(0xFF);
+    log->Begin(TEST_LOG_START, pSize, TEST_RECORD_SIZE);
+
+    for (uint16_t i = 0; i < pRecords; i++)
+    {
+        Append(*log, i, 1000 + i / pRate);
+
+        if (pRestart && ((i % pRestart) == pRestart - 1))
+        {
+            log->Flush();
+            delete log;
+            log = new DS3231EepromLogClass(pEeprom);
+            log->Begin(TEST_LOG_START, pSize, TEST_RECORD_SIZE);
+        }
+    }
+
+    log->Flush();
+    delete log;
+    log = new DS3231EepromLogClass(pEeprom);
+    log->Begin(TEST_LOG_START, pSize, TEST_RECORD_SIZE);
+
+    Check("log count", log->GetCount(), count);
+
+    for (uint16_t i = 0; ordered && (i < log->GetCount()); i++)
+    {
+        ordered = log->Read(i, seconds, payload) && (Number(payload) == pRecords - count + i);
+    }
+    Check("log order", ordered, true);
+
+    found = log->Find(1000 + (pRecords - 1) / pRate);
+    log->Read(found, seconds, payload);
+    found = ((pRecords - 1) / pRate) * pRate;
+    found = (found < pRecords - count) ? pRecords - count : found;
+    Check("log find", Number(payload), found);
+
+    delete log;
+}
+
+// The last burst of pRecords records, filling the rest of a page, is cut short at a random byte.
+// The records it did not complete are lost, the ones before it and all older records are kept.
+static void CheckTorn(DS3231EepromClass & pEeprom, uint16_t pRecords, uint16_t pSize)
+{
+    DS3231EepromLogClass log(pEeprom);
+    uint16_t slots = pSize / TEST_RECORD_SIZE;
+    uint16_t burst = TEST_RECORDS_PER_PAGE - pRecords % TEST_RECORDS_PER_PAGE;
+    uint16_t cut = Random(burst * TEST_RECORD_SIZE);
+    uint16_t intact = cut / TEST_RECORD_SIZE;
+    uint16_t total = pRecords + burst;
+    uint16_t valid = 0;
+    uint16_t expected;
+    uint16_t oldest;
+    uint16_t previous = 0;
+    uint32_t seconds;
+    uint8_t payload[2];
+    bool ordered = true;
+
+    SimReset(0xFF);
+    log.Begin(TEST_LOG_START, pSize, TEST_RECORD_SIZE);
+
+    for (uint16_t i = 0; i < total; i++)
+    {
+        if (i == pRecords)
+        {
+            log.Flush();
+            sTear = cut;
+        }
+
+        Append(log, i, 1000 + i / 3);
+    }
+    log.Flush();
+
+    // The slots after the torn ones still hold the previous lap
+    expected = ((total < slots) ? total : slots) - (burst - intact);
+    oldest = (total < slots) ? 0 : total - slots;
+
+    log.Begin(TEST_LOG_START, pSize, TEST_RECORD_SIZE);
+
+    for (uint16_t i = 0; i < log.GetCount(); i++)
+    {
+        if (!log.Read(i, seconds, payload))
+        {
+            continue;
+        }
+
+        ordered = ordered && ((valid == 0) ? (Number(payload) == oldest) : (Number(payload) > previous));
+        previous = Number(payload);
+        valid++;
+    }
+
+    Check("torn count", valid, expected);
+    Check("torn order", ordered, true);
+    Check("torn newest", valid ? (long)previous : -1L, (long)pRecords + intact - 1);
+
+    // Appending goes on after the newest intact record
+    Append(log, total, 2000);
+    log.Flush();
+    log.Begin(TEST_LOG_START, pSize, TEST_RECORD_SIZE);
+    log.Read(log.GetCount() - 1, seconds, payload);
+    Check("torn append", Number(payload), total);
+}
+
+int main(int argc, char * argv[])
+{
+    DS3231EepromClass eeprom;
+    int option;
+
+    while ((option = getopt(argc, argv, "r:")) != -1)
+    {
+        switch (option)
+        {
+        case 'r':
+            sRandom = strtoull(optarg, NULL, 0) | 1;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-r seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    DS3231Bus.SetTransfer(SimTransfer);
+    DS3231Bus.Begin(0);
+    eeprom.Begin();
+
+    CheckCoalescing(eeprom);
+    CheckPolling(eeprom);
+
+    CheckLog(eeprom, 300, 50, 0, 2048);
+    CheckLog(eeprom, 1000, 1000, 0, 2048);
+    CheckLog(eeprom, 700, 50, 37, 2048);
+    CheckLog(eeprom, 5000, 3, 0, 512);
+
+    // 8 slots, so 300 laps wrap the lap byte
+    CheckLog(eeprom, 2400, 10000, 0, 64);
+    CheckLog(eeprom, 2400, 10000, 13, 64);
+
+    for (uint16_t n = 1; n < 800; n += 7)
+    {
+        CheckLog(eeprom, n, n % 5 + 1, n % 13, 2048);
+    }
+
+    for (uint16_t n = 0; n < 600; n++)
+    {
+        CheckTorn(eeprom, n, (n % 2) ? 2048 : 256);
+    }
+
+    printf("%lu checks\n", sChecks);
+    printf("%lu failures\n", sFailures);
+
+    return sFailures ? 1 : 0;
+}
@@ -0,0 +1,49 @@
+/*
+DS3231Linux.cpp - Read the DS3231 Real-Time Clock from a Linux i2c-dev bus
+
+Build: g++ -O2 -I../.. -o DS3231Linux DS3231Linux.cpp ../../DS3231.cpp ../../DS3231Bus.cpp ../../CalendarHelper.cpp
+Usage: DS3231Linux [/dev/i2c-1]
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+
+#include "DS3231.h"
+
+DS3231Class DS3231;
+
+int main(int argc, char * argv[])
+{
+    const char * device = (argc > 1) ? argv[1] : "/dev/i2c-1";
+    char buffer[32];
+    sDateTime datetime;
+    int16_t temperature;
+
+    if (!DS3231Bus.Begin(device) || !DS3231.Begin())
+    {
+        perror(device);
+        return 1;
+    }
+
+    DS3231.GetDateTime(datetime);
+    temperature = DS3231.GetTemperatureRaw();
+
+    CalendarHelperClass::SPrintTime(buffer, datetime);
+    printf("%s %s%d.%02d C\n", buffer, (temperature < 0) ? "-" : "",
+        abs(temperature) / 4, abs(temperature) % 4 * 25);
+
+    DS3231Bus.End();
+
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*
+DS3231LogDecode.cpp - Host side decoder for logs written by DS3231LogWriterClass
+
+Prints one "unix time,temperature" line per sample, temperature in degrees Celsius.
+With -q only the record count and decoding throughput are reported.
+
+Build: g++ -O2 -I../.. -o DS3231LogDecode DS3231LogDecode.cpp
+Usage: DS3231LogDecode [-q] log.bin
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "DS3231LogFormat.h"
+
+#define UNIX_TIME_2000          (946684800UL)
+#define OUTPUT_BUFFER_SIZE      (1 << 16)
+#define OUTPUT_LINE_MAX         (32)
+
+static char * FormatUnsigned(char * pBuffer, uint32_t pValue)
+{
+    char digits[10];
+    uint8_t length = 0;
+
+    do
+    {
+        digits[length++] = '0' + (pValue % 10);
+        pValue /= 10;
+    } while (pValue);
+
+    while (length)
+    {
+        *pBuffer++ = digits[--length];
+    }
+
+    return pBuffer;
+}
+
+static char * FormatTemperature(char * pBuffer, int16_t pTemperature)
+{
+    static const char fractions[4][3] = { "00", "25", "50", "75" };
+    uint16_t value;
+
+    if (pTemperature < 0)
+    {
+        *pBuffer++ = '-';
+        value = -pTemperature;
+    }
+    else
+    {
+        value = pTemperature;
+    }
+
+    pBuffer = FormatUnsigned(pBuffer, value >> 2);
+    *pBuffer++ = '.';
+    *pBuffer++ = fractions[value & 3][0];
+    *pBuffer++ = fractions[value & 3][1];
+
+    return pBuffer;
+}
+
+static uint8_t * ReadFile(const char * pPath, size_t & pLength)
+{
+    FILE * file = fopen(pPath, "rb");
+    uint8_t * data = NULL;
+    uint8_t * grown;
+    size_t size = 0;
+
+    if (!file)
+    {
+        return NULL;
+    }
+
+    // Read in growing chunks, pipes and terminals have no length to seek to
+    pLength = 0;
+    do
+    {
+        if (pLength == size)
+        {
+            size = size ? size * 2 : 65536;
+            grown = (uint8_t *)realloc(data, size);
+            if (!grown)
+            {
+                free(data);
+                fclose(file);
+                return NULL;
+            }
+            data = grown;
+        }
+
+        pLength += fread(data + pLength, 1, size - pLength, file);
+    } while (pLength == size);
+
+    if (ferror(file))
+    {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+
+    return data;
+}
+
+int main(int argc, char * argv[])
+{
+    bool quiet = false;
+    const char * path = NULL;
+    uint8_t * data;
+    size_t length;
+    char * output;
+    char * cursor;
+    uint32_t seconds;
+    int16_t temperature;
+    unsigned long records = 0;
+    struct timespec start, end;
+    double elapsed;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-q") == 0)
+            quiet = true;
+        else
+            path = argv[i];
+    }
+
+    if (!path)
+    {
+        fprintf(stderr, "Usage: %s [-q] log.bin\n", argv[0]);
+        return 2;
+    }
+
+    data = ReadFile(path, length);
+    if (!data)
+    {
+        perror(path);
+        return 1;
+    }
+
+    output = (char *)malloc(OUTPUT_BUFFER_SIZE);
+    cursor = output;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    DS3231LogReaderClass reader(data, length);
+
+    while (reader.Next(seconds, temperature))
+    {
+        records++;
+
+        if (quiet)
+            continue;
+
+        cursor = FormatUnsigned(cursor, seconds + UNIX_TIME_2000);
+        *cursor++ = ',';
+        cursor = FormatTemperature(cursor, temperature);
+        *cursor++ = '\n';
+
+        if (cursor - output > OUTPUT_BUFFER_SIZE - OUTPUT_LINE_MAX)
+        {
+            fwrite(output, 1, cursor - output, stdout);
+            cursor = output;
+        }
+    }
+
+    fwrite(output, 1, cursor - output, stdout);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    fprintf(stderr, "%lu records from %zu bytes (%.2f bytes/record) in %.3f s, %.1f Mrecords/s\n",
+        records, length, records ? (double)length / records : 0.0, elapsed,
+        elapsed > 0 ? records / elapsed / 1e6 : 0.0);
+
+    if (reader.IsError())
+    {
+        fprintf(stderr, "%s: corrupt or truncated record at offset %zu\n", path, length - reader.Remaining());
+    }
+
+    free(output);
+    free(data);
+
+    return reader.IsError() ? 1 : 0;
+}
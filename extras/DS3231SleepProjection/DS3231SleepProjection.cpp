@@ -0,0 +1,87 @@
+/*
+DS3231SleepProjection.cpp - Project the duty cycle of a DS3231SleepClass schedule
+
+Runs a cron schedule through DS3231SleepClass::Project() in simulated time and
+prints wakes, time awake and asleep, duty cycle, average current and battery life.
+
+Build: g++ -O2 -I../.. -o DS3231SleepProjection DS3231SleepProjection.cpp ../../DS3231Sleep.cpp ../../DS3231Cron.cpp ../../DS3231.cpp ../../DS3231Bus.cpp ../../CalendarHelper.cpp
+Usage: DS3231SleepProjection [-a awake ms] [-d days] [-i awake mA] [-s asleep uA] [-c battery mAh] "cron expression"
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "DS3231Sleep.h"
+
+DS3231CronClass Cron;
+
+int main(int argc, char * argv[])
+{
+    uint32_t awake = 50;
+    uint32_t days = 365;
+    double awakeCurrent = 15.0;     // mA, ATmega328P at 16MHz
+    double asleepCurrent = 110.0;   // uA, power-down plus the RTC module
+    double capacity = 2000.0;       // mAh
+    sDS3231SleepProjection projection;
+    sDateTime start;
+    double duty;
+    double average;
+    int option;
+
+    while ((option = getopt(argc, argv, "a:d:i:s:c:")) != -1)
+    {
+        switch (option)
+        {
+        case 'a':
+            awake = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            days = strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            awakeCurrent = atof(optarg);
+            break;
+        case 's':
+            asleepCurrent = atof(optarg);
+            break;
+        case 'c':
+            capacity = atof(optarg);
+            break;
+        default:
+            optind = argc + 1;
+            break;
+        }
+    }
+
+    if ((optind != argc - 1) || !Cron.Compile(argv[optind]))
+    {
+        fprintf(stderr, "Usage: %s [-a awake ms] [-d days] [-i awake mA] [-s asleep uA] [-c battery mAh] \"cron expression\"\n", argv[0]);
+        return 2;
+    }
+
+    // A leap year starting on a saturday, days beyond it run into the following years
+    CalendarHelperClass::ConvertToDateTime(start, 0);
+    DS3231SleepClass::Project(Cron, start, days * SECS_PER_DAY, awake, projection);
+
+    duty = (double)projection.AwakeMillis / (projection.AwakeMillis + projection.AsleepMillis);
+    average = duty * awakeCurrent + (1.0 - duty) * asleepCurrent / 1000.0;
+
+    printf("%u days, %lu wakes, %lu fire times missed while awake\n", days, (unsigned long)projection.Wakes, (unsigned long)projection.Missed);
+    printf("awake %.1f s, asleep %.1f s, duty cycle %.4f%%\n", projection.AwakeMillis / 1000.0, projection.AsleepMillis / 1000.0, duty * 100.0);
+    printf("average current %.1f uA, %.0f days on %.0f mAh\n", average * 1000.0, capacity / average / 24.0, capacity);
+
+    return 0;
+}
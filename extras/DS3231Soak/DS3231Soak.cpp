@@ -0,0 +1,529 @@
+/*
+DS3231Soak.cpp - Virtual time soak test of the DS3231 driver, alarms and calendar
+
+Runs the driver against a simulated DS3231 hooked in through
+DS3231BusClass::SetTransfer(). The simulated chip keeps its time in BCD
+registers and matches alarms the way the datasheet describes, one virtual
+second per tick and no waiting. Random trials across 2000-2099 set the time
+and both alarms through the driver, then poll IsAlarm1/IsAlarm2 every
+virtual second and compare each fire, and each missing fire, against an
+oracle that works on plain second counts with its own calendar arithmetic.
+GetDateTime, ConvertToSeconds/ConvertToDateTime and the summer time dates of
+every year are checked against the same oracle.
+
+Build: g++ -O2 -I../.. -o DS3231Soak DS3231Soak.cpp ../../DS3231.cpp ../../DS3231Bus.cpp ../../CalendarHelper.cpp
+Usage: DS3231Soak [-s simulated seconds] [-r seed]
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "DS3231.h"
+
+#define SIM_REGISTERS           (0x13)
+#define SIM_CENTURY             (0x80)
+#define SOAK_SECONDS_2100       (3155760000UL) // Jan 1st of 2100
+#define SOAK_MAX_TRIAL          (45UL * 86400UL)
+#define SOAK_CHECK_INTERVAL     (3600UL)    // Virtual seconds between GetDateTime checks
+#define SOAK_REPORT_LIMIT       (10)        // Failures printed, the rest are only counted
+
+DS3231Class DS3231;
+
+/* Simulated DS3231 ------------------------------------------------------ */
+
+static uint8_t sRegisters[SIM_REGISTERS];
+static uint8_t sPointer;
+
+static uint8_t Bcd(uint8_t pValue)
+{
+    return ((pValue / 10) << 4) | (pValue % 10);
+}
+
+static uint8_t Dec(uint8_t pValue)
+{
+    return (pValue >> 4) * 10 + (pValue & 0x0F);
+}
+
+static void SimWrite(uint8_t pValue)
+{
+    uint8_t status;
+
+    if (sPointer == DS3231_REG_STATUS)
+    {
+        // OSF and the alarm flags can only be cleared, BSY is read only
+        status = sRegisters[DS3231_REG_STATUS];
+        sRegisters[DS3231_REG_STATUS] = (status & pValue & (DS3231_STATUS_OSF | DS3231_STATUS_A2F | DS3231_STATUS_A1F))
+            | (pValue & DS3231_STATUS_EN32KHZ) | (status & DS3231_STATUS_BSY);
+    }
+    else if (sPointer < DS3231_REG_TEMPERATURE)
+    {
+        sRegisters[sPointer] = pValue;
+    }
+
+    sPointer = (sPointer + 1) % SIM_REGISTERS;
+}
+
+static int SimTransfer(int pFd, struct i2c_rdwr_ioctl_data * pData)
+{
+    (void)pFd;
+
+    for (uint32_t i = 0; i < pData->nmsgs; i++)
+    {
+        struct i2c_msg & message = pData->msgs[i];
+
+        if (message.addr != DS3231_ADDRESS)
+        {
+            return -1;
+        }
+
+        if (message.flags & I2C_M_RD)
+        {
+            for (uint16_t j = 0; j < message.len; j++)
+            {
+                message.buf[j] = sRegisters[sPointer];
+                sPointer = (sPointer + 1) % SIM_REGISTERS;
+            }
+        }
+        else if (message.len != 0)
+        {
+            sPointer = message.buf[0] % SIM_REGISTERS;
+
+            for (uint16_t j = 1; j < message.len; j++)
+            {
+                SimWrite(message.buf[j]);
+            }
+        }
+    }
+
+    return pData->nmsgs;
+}
+
+static uint8_t SimMonthLength(uint8_t pMonth, uint8_t pYear)
+{
+    static const uint8_t length[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    // The chip's leap year rule, right from 2000 to 2099
+    return ((pMonth == 2) && ((pYear % 4) == 0)) ? 29 : length[pMonth - 1];
+}
+
+// Advance the time registers by one second, then match the alarms
+static void SimTick(void)
+{
+    uint8_t * r = sRegisters;
+    uint8_t month;
+    uint8_t year;
+
+    r[0] = Bcd(Dec(r[0]) + 1);
+    if (r[0] == 0x60)
+    {
+        r[0] = 0;
+        r[1] = Bcd(Dec(r[1]) + 1);
+        if (r[1] == 0x60)
+        {
+            r[1] = 0;
+            r[2] = Bcd(Dec(r[2] & 0x3F) + 1);
+            if (r[2] == 0x24)
+            {
+                r[2] = 0;
+                r[3] = (r[3] % 7) + 1;
+
+                month = Dec(r[5] & 0x1F);
+                year = Dec(r[6]);
+                r[4] = Bcd(Dec(r[4]) + 1);
+                if (Dec(r[4]) > SimMonthLength(month, year))
+                {
+                    r[4] = 1;
+                    r[5] = (r[5] & SIM_CENTURY) | Bcd(month + 1);
+                    if (month == 12)
+                    {
+                        r[5] = (r[5] & SIM_CENTURY) | 1;
+                        r[6] = Bcd((year + 1) % 100);
+                        if (year == 99)
+                        {
+                            r[5] ^= SIM_CENTURY;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    const uint8_t * a1 = &r[DS3231_REG_ALARM_1];
+    const uint8_t * a2 = &r[DS3231_REG_ALARM_2];
+
+    bool day1 = (a1[3] & DS3231_ALARM_DY) ? ((a1[3] & 0x0F) == r[3]) : ((a1[3] & 0x3F) == r[4]);
+    bool day2 = (a2[2] & DS3231_ALARM_DY) ? ((a2[2] & 0x0F) == r[3]) : ((a2[2] & 0x3F) == r[4]);
+
+    if (((a1[0] & 0x80) || ((a1[0] & 0x7F) == r[0])) &&
+        ((a1[1] & 0x80) || ((a1[1] & 0x7F) == r[1])) &&
+        ((a1[2] & 0x80) || ((a1[2] & 0x3F) == r[2])) &&
+        ((a1[3] & 0x80) || day1))
+    {
+        r[DS3231_REG_STATUS] |= DS3231_STATUS_A1F;
+    }
+
+    if ((r[0] == 0) &&
+        ((a2[0] & 0x80) || ((a2[0] & 0x7F) == r[1])) &&
+        ((a2[1] & 0x80) || ((a2[1] & 0x3F) == r[2])) &&
+        ((a2[2] & 0x80) || day2))
+    {
+        r[DS3231_REG_STATUS] |= DS3231_STATUS_A2F;
+    }
+}
+
+/* Oracle ---------------------------------------------------------------- */
+
+struct sCivil
+{
+    int Year;
+    int Month;
+    int Day;
+    int Weekday; // Sunday == 1, as counted by the chip
+    int Hour;
+    int Minute;
+    int Second;
+};
+
+// Days from 1970-01-01 to the given date, proleptic Gregorian (H. Hinnant)
+static long DaysFromCivil(int pYear, int pMonth, int pDay)
+{
+    long year = pYear - (pMonth <= 2);
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yoe = year - era * 400;
+    long doy = (153 * (pMonth + (pMonth > 2 ? -3 : 9)) + 2) / 5 + pDay - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+static void CivilFromDays(long pDays, int & pYear, int & pMonth, int & pDay)
+{
+    long z = pDays + 719468;
+    long era = (z >= 0 ? z : z - 146096) / 146097;
+    long doe = z - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+
+    pDay = doy - (153 * mp + 2) / 5 + 1;
+    pMonth = mp < 10 ? mp + 3 : mp - 9;
+    pYear = yoe + era * 400 + (pMonth <= 2);
+}
+
+static const long sEpoch2000 = DaysFromCivil(2000, 1, 1);
+
+static void OracleCivil(sCivil & pCivil, uint32_t pSeconds)
+{
+    long days = pSeconds / 86400 + sEpoch2000;
+    uint32_t time = pSeconds % 86400;
+
+    CivilFromDays(days, pCivil.Year, pCivil.Month, pCivil.Day);
+    pCivil.Weekday = ((days % 7) + 11) % 7 + 1; // 1970-01-01 was a Thursday
+    pCivil.Hour = time / 3600;
+    pCivil.Minute = (time / 60) % 60;
+    pCivil.Second = time % 60;
+}
+
+struct sOracleAlarm
+{
+    int Number;
+    uint8_t Mode;
+    int Day;
+    int Hour;
+    int Minute;
+    int Second;
+};
+
+static bool OracleFires(const sOracleAlarm & pAlarm, const sCivil & pNow)
+{
+    switch (pAlarm.Number * 0x100 + pAlarm.Mode)
+    {
+    case 0x100 + DS3231_EVERY_SECOND:   return true;
+    case 0x100 + DS3231_MATCH_S:        return pNow.Second == pAlarm.Second;
+    case 0x100 + DS3231_MATCH_M_S:      return (pNow.Second == pAlarm.Second) && (pNow.Minute == pAlarm.Minute);
+    case 0x100 + DS3231_MATCH_H_M_S:    return (pNow.Second == pAlarm.Second) && (pNow.Minute == pAlarm.Minute) && (pNow.Hour == pAlarm.Hour);
+    case 0x100 + DS3231_MATCH_DT_H_M_S: return (pNow.Second == pAlarm.Second) && (pNow.Minute == pAlarm.Minute) && (pNow.Hour == pAlarm.Hour) && (pNow.Day == pAlarm.Day);
+    case 0x100 + DS3231_MATCH_DY_H_M_S: return (pNow.Second == pAlarm.Second) && (pNow.Minute == pAlarm.Minute) && (pNow.Hour == pAlarm.Hour) && (pNow.Weekday == pAlarm.Day);
+    case 0x200 + DS3231_EVERY_MINUTE:   return pNow.Second == 0;
+    case 0x200 + DS3231_MATCH_M:        return (pNow.Second == 0) && (pNow.Minute == pAlarm.Minute);
+    case 0x200 + DS3231_MATCH_H_M:      return (pNow.Second == 0) && (pNow.Minute == pAlarm.Minute) && (pNow.Hour == pAlarm.Hour);
+    case 0x200 + DS3231_MATCH_DT_H_M:   return (pNow.Second == 0) && (pNow.Minute == pAlarm.Minute) && (pNow.Hour == pAlarm.Hour) && (pNow.Day == pAlarm.Day);
+    case 0x200 + DS3231_MATCH_DY_H_M:   return (pNow.Second == 0) && (pNow.Minute == pAlarm.Minute) && (pNow.Hour == pAlarm.Hour) && (pNow.Weekday == pAlarm.Day);
+    default:                            return false;
+    }
+}
+
+// Easter Sunday, Gauss' algorithm with the Lichtenberg corrections
+static void OracleEaster(int pYear, int & pMonth, int & pDay)
+{
+    int k = pYear / 100;
+    int m = 15 + (3 * k + 3) / 4 - (8 * k + 13) / 25;
+    int s = 2 - (3 * k + 3) / 4;
+    int a = pYear % 19;
+    int d = (19 * a + m) % 30;
+    int r = (d + a / 11) / 29;
+    int og = 21 + d - r;
+    int sz = 7 - (pYear + pYear / 4 + s) % 7;
+    int oe = 7 - (og - sz) % 7;
+    int os = og + oe; // Day of March, above 31 is in April
+
+    pMonth = (os > 31) ? 4 : 3;
+    pDay = (os > 31) ? os - 31 : os;
+}
+
+/* Soak ------------------------------------------------------------------ */
+
+static uint64_t sRandom = 0x2545F4914F6CDD1DULL;
+static unsigned long sFailures;
+static unsigned long sReported;
+
+static uint32_t Random(uint32_t pRange)
+{
+    sRandom ^= sRandom << 13;
+    sRandom ^= sRandom >> 7;
+    sRandom ^= sRandom << 17;
+
+    return (uint32_t)((sRandom >> 16) % pRange);
+}
+
+static void Fail(const char * pCheck, uint32_t pSeconds, const char * pDetail)
+{
+    sCivil civil;
+
+    sFailures++;
+    if (sReported++ >= SOAK_REPORT_LIMIT)
+    {
+        return;
+    }
+
+    OracleCivil(civil, pSeconds);
+    printf("FAIL %-16s %04d-%02d-%02d %02d:%02d:%02d  %s\n", pCheck,
+        civil.Year, civil.Month, civil.Day, civil.Hour, civil.Minute, civil.Second, pDetail);
+}
+
+static bool SameDate(const sDateTime & pDateTime, const sCivil & pCivil)
+{
+    return (pDateTime.Year == pCivil.Year) && (pDateTime.Month == pCivil.Month) && (pDateTime.Day == pCivil.Day) &&
+        (pDateTime.Hour == pCivil.Hour) && (pDateTime.Minute == pCivil.Minute) && (pDateTime.Second == pCivil.Second) &&
+        (pDateTime.DayOfWeek == pCivil.Weekday);
+}
+
+static void CheckTime(uint32_t pSeconds, const sCivil & pCivil)
+{
+    sDateTime datetime;
+    uint32_t seconds;
+    char detail[64];
+
+    DS3231.GetDateTime(datetime);
+    if (!SameDate(datetime, pCivil))
+    {
+        snprintf(detail, sizeof(detail), "read %04u-%02u-%02u %02u:%02u:%02u dow %u, expected dow %d",
+            datetime.Year, datetime.Month, datetime.Day, datetime.Hour, datetime.Minute, datetime.Second,
+            datetime.DayOfWeek, pCivil.Weekday);
+        Fail("GetDateTime", pSeconds, detail);
+    }
+
+    CalendarHelperClass::ConvertToDateTime(datetime, pSeconds);
+    if (!SameDate(datetime, pCivil))
+    {
+        snprintf(detail, sizeof(detail), "got %04u-%02u-%02u %02u:%02u:%02u dow %u",
+            datetime.Year, datetime.Month, datetime.Day, datetime.Hour, datetime.Minute, datetime.Second, datetime.DayOfWeek);
+        Fail("ConvertToDateTime", pSeconds, detail);
+    }
+
+    CalendarHelperClass::ConvertToSeconds(seconds, datetime);
+    if (seconds != pSeconds)
+    {
+        snprintf(detail, sizeof(detail), "got %lu", (unsigned long)seconds);
+        Fail("ConvertToSeconds", pSeconds, detail);
+    }
+}
+
+static void RandomAlarm(sOracleAlarm & pAlarm, int pNumber)
+{
+    static const uint8_t modes1[] = { DS3231_EVERY_SECOND, DS3231_MATCH_S, DS3231_MATCH_M_S, DS3231_MATCH_H_M_S, DS3231_MATCH_DT_H_M_S, DS3231_MATCH_DY_H_M_S };
+    static const uint8_t modes2[] = { DS3231_EVERY_MINUTE, DS3231_MATCH_M, DS3231_MATCH_H_M, DS3231_MATCH_DT_H_M, DS3231_MATCH_DY_H_M };
+
+    pAlarm.Number = pNumber;
+    pAlarm.Mode = (pNumber == 1) ? modes1[Random(sizeof(modes1))] : modes2[Random(sizeof(modes2))];
+    pAlarm.Hour = Random(24);
+    pAlarm.Minute = Random(60);
+    pAlarm.Second = (pNumber == 1) ? Random(60) : 0;
+
+    if ((pAlarm.Mode == DS3231_MATCH_DY_H_M_S) || (pAlarm.Mode == DS3231_MATCH_DY_H_M))
+    {
+        pAlarm.Day = Random(7) + 1;
+    }
+    else
+    {
+        pAlarm.Day = Random(31) + 1;
+    }
+}
+
+static void CheckAlarm(const sOracleAlarm & pAlarm, uint32_t pSeconds, const sCivil & pCivil, unsigned long & pFires)
+{
+    bool expected = OracleFires(pAlarm, pCivil);
+    bool fired = (pAlarm.Number == 1) ? DS3231.IsAlarm1() : DS3231.IsAlarm2();
+    char detail[64];
+
+    if (fired != expected)
+    {
+        snprintf(detail, sizeof(detail), "mode 0x%02X day %d %02d:%02d:%02d %s", pAlarm.Mode,
+            pAlarm.Day, pAlarm.Hour, pAlarm.Minute, pAlarm.Second, fired ? "fired" : "missed");
+        Fail((pAlarm.Number == 1) ? "Alarm1" : "Alarm2", pSeconds, detail);
+    }
+
+    if (fired)
+    {
+        pFires++;
+    }
+}
+
+static void CheckSummerTime(void)
+{
+    sDateTime begin;
+    sDateTime end;
+    char detail[64];
+    int month;
+    int day;
+    long carnaval;
+    int first;
+    int third;
+
+    for (int year = 2000; year <= 2099; year++)
+    {
+        // First sunday of November
+        first = 1 + (7 - (int)((DaysFromCivil(year, 11, 1) % 7 + 11) % 7)) % 7;
+
+        CalendarHelperClass::BeginningOfSummerTime(begin, year);
+        if ((begin.Year != year) || (begin.Month != 11) || (begin.Day != first))
+        {
+            snprintf(detail, sizeof(detail), "beginning %04u-%02u-%02u, expected %04d-11-%02d", begin.Year, begin.Month, begin.Day, year, first);
+            Fail("SummerTime", (DaysFromCivil(year, 1, 1) - sEpoch2000) * 86400UL, detail);
+        }
+
+        // Third sunday of February, a week later if that is carnaval (Easter - 49 days)
+        third = 15 + (7 - (int)((DaysFromCivil(year, 2, 15) % 7 + 11) % 7)) % 7;
+        OracleEaster(year, month, day);
+        carnaval = DaysFromCivil(year, month, day) - 49;
+        if (carnaval == DaysFromCivil(year, 2, third))
+        {
+            third += 7;
+        }
+
+        CalendarHelperClass::EndingOfSummerTime(end, year);
+        if ((end.Year != year) || (end.Month != 2) || (end.Day != third))
+        {
+            snprintf(detail, sizeof(detail), "ending %04u-%02u-%02u, expected %04d-02-%02d", end.Year, end.Month, end.Day, year, third);
+            Fail("SummerTime", (DaysFromCivil(year, 1, 1) - sEpoch2000) * 86400UL, detail);
+        }
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    uint64_t budget = 200000000ULL;
+    uint64_t simulated = 0;
+    unsigned long trials = 0;
+    unsigned long fires = 0;
+    sOracleAlarm alarm1;
+    sOracleAlarm alarm2;
+    sDateTime datetime;
+    sCivil civil;
+    uint32_t now;
+    uint32_t length;
+    struct timespec start;
+    struct timespec stop;
+    double elapsed;
+    int option;
+
+    while ((option = getopt(argc, argv, "s:r:")) != -1)
+    {
+        switch (option)
+        {
+        case 's':
+            budget = strtoull(optarg, NULL, 0);
+            break;
+        case 'r':
+            sRandom = strtoull(optarg, NULL, 0) | 1;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-s simulated seconds] [-r seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    DS3231Bus.SetTransfer(SimTransfer);
+    DS3231Bus.Begin(0);
+    DS3231.Begin();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    CheckSummerTime();
+
+    while (simulated < budget)
+    {
+        length = Random(SOAK_MAX_TRIAL) + 1;
+        now = Random(SOAK_SECONDS_2100 - length);
+
+        OracleCivil(civil, now);
+        datetime.Year = civil.Year;
+        datetime.Month = civil.Month;
+        datetime.Day = civil.Day;
+        datetime.Hour = civil.Hour;
+        datetime.Minute = civil.Minute;
+        datetime.Second = civil.Second;
+        DS3231.SetDateTime(datetime);
+        CheckTime(now, civil);
+
+        RandomAlarm(alarm1, 1);
+        RandomAlarm(alarm2, 2);
+        DS3231.SetAlarm1(alarm1.Day, alarm1.Hour, alarm1.Minute, alarm1.Second, (eDS3231_alarm1_t)alarm1.Mode);
+        DS3231.SetAlarm2(alarm2.Day, alarm2.Hour, alarm2.Minute, (eDS3231_alarm2_t)alarm2.Mode);
+        DS3231.ClearAlarm1();
+        DS3231.ClearAlarm2();
+
+        for (uint32_t i = 0; i < length; i++)
+        {
+            SimTick();
+            now++;
+
+            OracleCivil(civil, now);
+            CheckAlarm(alarm1, now, civil, fires);
+            CheckAlarm(alarm2, now, civil, fires);
+
+            if ((now % SOAK_CHECK_INTERVAL) == 0)
+            {
+                CheckTime(now, civil);
+            }
+        }
+
+        simulated += length;
+        trials++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    elapsed = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("%lu trials, %llu simulated seconds (%.1f years), %lu alarm fires checked\n",
+        trials, (unsigned long long)simulated, simulated / 31556952.0, fires);
+    printf("%.2f s, %.0f simulated seconds per second\n", elapsed, simulated / elapsed);
+    printf("%lu failures\n", sFailures);
+
+    return sFailures ? 1 : 0;
+}
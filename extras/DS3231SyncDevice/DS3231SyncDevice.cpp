@@ -0,0 +1,488 @@
+/*
+DS3231SyncDevice.cpp - End to end test of DS3231SyncClass against DS3231SyncHost
+
+Runs DS3231SyncClass on the host, in real time, against a simulated DS3231
+hooked in through DS3231BusClass::SetTransfer() and a Stream on the pseudo
+terminal of a DS3231SyncHost process. The simulated chip runs from
+CLOCK_MONOTONIC with a frequency error of its own, less 0.1ppm per step of
+its aging register, and restarts its second when the time is written.
+CLOCK_REALTIME plus the host's offset is the reference its error is
+measured against.
+
+Three phases are checked:
+
+ - large: the RTC starts -e ms off, one Synchronize() has to correct it in
+   one step;
+ - small: -s ms are added, each Synchronize() may step the RTC by at most
+   DS3231_SYNC_MAX_STEP, until the error is gone;
+ - trim: -t synchronisations DS3231_SYNC_TRIM_INTERVAL apart, the aging
+   register has to move against the -d ppm frequency error.
+
+The trim interval is shortened at build time so the test takes about a minute.
+
+Build: g++ -O2 -DDS3231_SYNC_TRIM_INTERVAL=10 -include DS3231SyncShim.h -I. -I../.. -o DS3231SyncDevice DS3231SyncDevice.cpp ../../DS3231Sync.cpp ../../DS3231.cpp ../../DS3231Bus.cpp ../../CalendarHelper.cpp
+Usage: DS3231SyncDevice [-e large offset ms] [-s small offset ms] [-d ppm] [-t trims] [-o host offset ms] (-H DS3231SyncHost | /dev/pts/N)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+
+#include "DS3231SyncShim.h"
+#include "DS3231Sync.h"
+
+#define UNIX_TIME_2000          (946684800LL)
+#define SIM_REGISTERS           (0x13)
+#define SYNC_TOLERANCE          (20)        // ms of error left after a correction
+
+/* Time ------------------------------------------------------------------ */
+
+static long long Micros(clockid_t pClock)
+{
+    struct timespec now;
+
+    clock_gettime(pClock, &now);
+
+    return (long long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static long long sStart = Micros(CLOCK_MONOTONIC);
+static long sHostOffset = 0;
+
+unsigned long millis(void)
+{
+    return (unsigned long)((Micros(CLOCK_MONOTONIC) - sStart) / 1000);
+}
+
+void delay(unsigned long pMillis)
+{
+    struct timespec wait;
+
+    wait.tv_sec = pMillis / 1000;
+    wait.tv_nsec = (pMillis % 1000) * 1000000L;
+    nanosleep(&wait, NULL);
+}
+
+// The host's time in us since Jan 1st of 2000
+static long long HostMicros(void)
+{
+    return Micros(CLOCK_REALTIME) - UNIX_TIME_2000 * 1000000 + sHostOffset * 1000LL;
+}
+
+/* Simulated DS3231 ------------------------------------------------------ */
+
+static uint8_t sRegisters[SIM_REGISTERS];
+static uint8_t sPointer;
+static bool sTimeWritten;
+static double sDrift = 200;     // ppm with the aging register at 0
+static long long sBase;         // Simulated time in us since 2000 at sReference
+static long long sReference;    // CLOCK_MONOTONIC us
+
+static uint8_t Bcd(uint8_t pValue)
+{
+    return ((pValue / 10) << 4) | (pValue % 10);
+}
+
+static uint8_t Dec(uint8_t pValue)
+{
+    return (pValue >> 4) * 10 + (pValue & 0x0F);
+}
+
+static double SimPpm(void)
+{
+    return sDrift - (int8_t)sRegisters[DS3231_REG_AGING] * 0.1;
+}
+
+static long long SimNow(void)
+{
+    long long elapsed = Micros(CLOCK_MONOTONIC) - sReference;
+
+    return sBase + elapsed + (long long)(elapsed * SimPpm() / 1000000.0);
+}
+
+static void SimSet(long long pMicros)
+{
+    sReference = Micros(CLOCK_MONOTONIC);
+    sBase = pMicros;
+}
+
+static void SimRender(void)
+{
+    sDateTime datetime;
+
+    CalendarHelperClass::ConvertToDateTime(datetime, (uint32_t)(SimNow() / 1000000));
+
+    sRegisters[0] = Bcd(datetime.Second);
+    sRegisters[1] = Bcd(datetime.Minute);
+    sRegisters[2] = Bcd(datetime.Hour);
+    sRegisters[3] = datetime.DayOfWeek;
+    sRegisters[4] = Bcd(datetime.Day);
+    sRegisters[5] = Bcd(datetime.Month);
+    sRegisters[6] = Bcd(datetime.Year - 2000);
+}
+
+static void SimWrite(uint8_t pValue)
+{
+    if (sPointer < DS3231_REG_ALARM_1)
+    {
+        sTimeWritten = true;
+    }
+
+    if (sPointer == DS3231_REG_AGING)
+    {
+        // The new rate applies from now on
+        SimSet(SimNow());
+    }
+
+    if (sPointer < DS3231_REG_TEMPERATURE)
+    {
+        sRegisters[sPointer] = pValue;
+    }
+
+    sPointer = (sPointer + 1) % SIM_REGISTERS;
+}
+
+static int SimTransfer(int pFd, struct i2c_rdwr_ioctl_data * pData)
+{
+    sDateTime datetime;
+    uint32_t seconds;
+
+    (void)pFd;
+
+    SimRender();
+    sTimeWritten = false;
+
+    for (uint32_t i = 0; i < pData->nmsgs; i++)
+    {
+        struct i2c_msg & message = pData->msgs[i];
+
+        if (message.addr != DS3231_ADDRESS)
+        {
+            return -1;
+        }
+
+        if (message.flags & I2C_M_RD)
+        {
+            for (uint16_t j = 0; j < message.len; j++)
+            {
+                message.buf[j] = sRegisters[sPointer];
+                sPointer = (sPointer + 1) % SIM_REGISTERS;
+            }
+        }
+        else if (message.len != 0)
+        {
+            sPointer = message.buf[0] % SIM_REGISTERS;
+
+            for (uint16_t j = 1; j < message.len; j++)
+            {
+                SimWrite(message.buf[j]);
+            }
+        }
+    }
+
+    // Writing the time restarts the countdown chain, the second starts now
+    if (sTimeWritten)
+    {
+        datetime.Second = Dec(sRegisters[0]);
+        datetime.Minute = Dec(sRegisters[1]);
+        datetime.Hour = Dec(sRegisters[2] & 0x3F);
+        datetime.Day = Dec(sRegisters[4]);
+        datetime.Month = Dec(sRegisters[5] & 0x1F);
+        datetime.Year = 2000 + Dec(sRegisters[6]);
+        CalendarHelperClass::ConvertToSeconds(seconds, datetime);
+        SimSet((long long)seconds * 1000000);
+    }
+
+    return pData->nmsgs;
+}
+
+// RTC minus host time in ms
+static double SimError(void)
+{
+    return (SimNow() - HostMicros()) / 1000.0;
+}
+
+/* Stream on the pseudo terminal ----------------------------------------- */
+
+class PtyStream : public Stream
+{
+public:
+    PtyStream(int pFd) : mFd(pFd) {}
+
+    int available(void)
+    {
+        int count = 0;
+
+        return (ioctl(mFd, FIONREAD, &count) == 0) ? count : 0;
+    }
+
+    int read(void)
+    {
+        uint8_t byte;
+
+        return (available() && (::read(mFd, &byte, 1) == 1)) ? byte : -1;
+    }
+
+    size_t write(const uint8_t * pBuffer, size_t pSize)
+    {
+        ssize_t written = ::write(mFd, pBuffer, pSize);
+
+        return (written < 0) ? 0 : (size_t)written;
+    }
+
+    size_t readBytes(uint8_t * pBuffer, size_t pLength)
+    {
+        struct pollfd wait = { mFd, POLLIN, 0 };
+        unsigned long start = millis();
+        size_t length = 0;
+        ssize_t count;
+
+        while ((length < pLength) && (millis() - start < mTimeout))
+        {
+            if (poll(&wait, 1, mTimeout - (millis() - start)) <= 0)
+            {
+                break;
+            }
+
+            count = ::read(mFd, pBuffer + length, pLength - length);
+            if (count <= 0)
+            {
+                break;
+            }
+            length += count;
+        }
+
+        return length;
+    }
+
+private:
+    int mFd;
+};
+
+/* Host process ---------------------------------------------------------- */
+
+static pid_t sHost = -1;
+
+// Start DS3231SyncHost -p and return the pseudo terminal it prints
+static bool StartHost(const char * pPath, char * pPty, size_t pSize)
+{
+    char offset[16];
+    int pipes[2];
+    FILE * output;
+
+    snprintf(offset, sizeof(offset), "%ld", sHostOffset);
+
+    if (pipe(pipes) < 0)
+    {
+        return false;
+    }
+
+    sHost = fork();
+    if (sHost == 0)
+    {
+        dup2(pipes[1], STDOUT_FILENO);
+        close(pipes[0]);
+        close(pipes[1]);
+        execl(pPath, pPath, "-p", "-o", offset, (char *)NULL);
+        perror(pPath);
+        _exit(1);
+    }
+
+    close(pipes[1]);
+    output = fdopen(pipes[0], "r");
+
+    if ((sHost < 0) || !output || !fgets(pPty, pSize, output))
+    {
+        return false;
+    }
+
+    pPty[strcspn(pPty, "\n")] = 0;
+
+    return true;
+}
+
+static void StopHost(void)
+{
+    if (sHost > 0)
+    {
+        kill(sHost, SIGTERM);
+        waitpid(sHost, NULL, 0);
+    }
+}
+
+static int OpenPty(const char * pPath)
+{
+    struct termios tio;
+    int fd = open(pPath, O_RDWR | O_NOCTTY);
+
+    if (fd < 0)
+    {
+        perror(pPath);
+        return -1;
+    }
+
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    return fd;
+}
+
+/* Test ------------------------------------------------------------------ */
+
+static int sFailures = 0;
+
+static void Check(bool pCondition, const char * pWhat)
+{
+    if (!pCondition)
+    {
+        printf("FAIL: %s\n", pWhat);
+        sFailures++;
+    }
+}
+
+static bool Synchronize(DS3231SyncClass & pSync, const char * pPhase, double & pError)
+{
+    bool answered = pSync.Synchronize();
+
+    pError = SimError();
+
+    printf("%-6s offset %7ld ms  delay %3u ms  %-7s  aging %4d  error %8.1f ms\n", pPhase,
+        (long)pSync.GetOffset(), pSync.GetDelay(), pSync.IsStepped() ? "whole" : "limited",
+        (int8_t)sRegisters[DS3231_REG_AGING], pError);
+
+    Check(answered, "host did not answer");
+
+    return answered;
+}
+
+int main(int argc, char * argv[])
+{
+    const char * host = NULL;
+    long large = 30000;
+    long small = 1800;
+    int trims = 4;
+    char pty[64];
+    double before;
+    double error;
+    int fd;
+    int option;
+
+    while ((option = getopt(argc, argv, "e:s:d:t:o:H:")) != -1)
+    {
+        switch (option)
+        {
+        case 'e': large = strtol(optarg, NULL, 10); break;
+        case 's': small = strtol(optarg, NULL, 10); break;
+        case 'd': sDrift = atof(optarg); break;
+        case 't': trims = atoi(optarg); break;
+        case 'o': sHostOffset = strtol(optarg, NULL, 10); break;
+        case 'H': host = optarg; break;
+        default: optind = argc + 1; break;
+        }
+    }
+
+    if ((host ? (optind != argc) : (optind != argc - 1)) || (labs(large) < DS3231_SYNC_STEP_THRESHOLD) || (labs(small) >= DS3231_SYNC_STEP_THRESHOLD))
+    {
+        fprintf(stderr, "Usage: %s [-e large offset ms] [-s small offset ms] [-d ppm] [-t trims] [-o host offset ms] (-H DS3231SyncHost | /dev/pts/N)\n", argv[0]);
+        fprintf(stderr, "the large offset has to be %ld ms or more either way, the small one less\n", DS3231_SYNC_STEP_THRESHOLD);
+        return 2;
+    }
+
+    if (host)
+    {
+        if (!StartHost(host, pty, sizeof(pty)))
+        {
+            fprintf(stderr, "%s did not start\n", host);
+            StopHost();
+            return 1;
+        }
+    }
+    else
+    {
+        snprintf(pty, sizeof(pty), "%s", argv[optind]);
+    }
+
+    fd = OpenPty(pty);
+    if (fd < 0)
+    {
+        StopHost();
+        return 1;
+    }
+
+    DS3231Bus.SetTransfer(SimTransfer);
+    DS3231Bus.Begin(0);
+
+    DS3231Class DS3231;
+    PtyStream stream(fd);
+    DS3231SyncClass sync(DS3231, stream);
+
+    printf("%s, RTC %.1f ppm, trim interval %lu s\n", pty, sDrift, (unsigned long)DS3231_SYNC_TRIM_INTERVAL);
+
+    // Large offset, corrected in one step
+    SimSet(HostMicros() + large * 1000LL);
+    if (Synchronize(sync, "large", error))
+    {
+        Check(sync.IsStepped(), "offset over the step threshold was not corrected in one step");
+        Check(labs((long)error) <= SYNC_TOLERANCE, "error left after the step");
+    }
+
+    // Small offset, DS3231_SYNC_MAX_STEP per synchronisation
+    SimSet(SimNow() + small * 1000LL);
+    for (long i = 0; i <= labs(small) / DS3231_SYNC_MAX_STEP; i++)
+    {
+        before = SimError();
+        if (!Synchronize(sync, "small", error))
+        {
+            break;
+        }
+
+        Check(!sync.IsStepped(), "offset under the step threshold was corrected in one step");
+        Check(fabs(error - before) <= DS3231_SYNC_MAX_STEP + SYNC_TOLERANCE, "stepped by more than the limit");
+    }
+    Check(fabs(error) <= SYNC_TOLERANCE, "error left after the small steps");
+
+    // Trim, the aging register has to take up the frequency error
+    for (int i = 0; i < trims; i++)
+    {
+        delay(DS3231_SYNC_TRIM_INTERVAL * 1000UL);
+        if (!Synchronize(sync, "trim", error))
+        {
+            break;
+        }
+    }
+    if (trims > 1)
+    {
+        Check(fabs(SimPpm()) < fabs(sDrift), "aging did not reduce the frequency error");
+    }
+
+    printf("RTC %.1f ppm after trimming, %d failures\n", SimPpm(), sFailures);
+
+    close(fd);
+    StopHost();
+
+    return sFailures ? 1 : 0;
+}
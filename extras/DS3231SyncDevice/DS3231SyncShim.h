@@ -0,0 +1,52 @@
+/*
+DS3231SyncShim.h - The part of the Arduino API DS3231SyncClass uses, for the host
+
+DS3231Sync.h expects Stream, millis() and delay() to be declared by Arduino.h.
+On the host this header declares them instead. The build line of
+DS3231SyncDevice forces it in front of every source with -include, and
+DS3231SyncDevice.cpp supplies millis() and delay().
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231SyncShim_h
+#define _DS3231SyncShim_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// The part of Arduino's Stream used by DS3231SyncClass
+class Stream
+{
+public:
+    Stream(void) : mTimeout(1000) {}
+    virtual ~Stream(void) {}
+
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+    virtual size_t write(const uint8_t * pBuffer, size_t pSize) = 0;
+    virtual size_t readBytes(uint8_t * pBuffer, size_t pLength) = 0; // Wait up to the timeout for pLength bytes
+
+    void setTimeout(unsigned long pTimeout) { mTimeout = pTimeout; }
+
+protected:
+    unsigned long mTimeout;
+};
+
+unsigned long millis(void);
+void delay(unsigned long pMillis);
+
+#endif
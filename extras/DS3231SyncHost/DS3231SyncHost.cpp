@@ -0,0 +1,187 @@
+/*
+DS3231SyncHost.cpp - Host side of the DS3231SyncClass timestamp exchange
+
+Answers synchronisation requests on a serial port with the host's
+CLOCK_REALTIME. With -p a pseudo terminal is created instead and its name
+printed, so a device emulation running as a local process can connect to it.
+-o adds a fixed offset in milliseconds to the served time, to exercise the
+limited and the single step corrections.
+
+Build: g++ -O2 -I../.. -o DS3231SyncHost DS3231SyncHost.cpp
+Usage: DS3231SyncHost [-o offset_ms] [-b baud] (-p | /dev/ttyUSB0)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "DS3231SyncFormat.h"
+
+#define UNIX_TIME_2000              (946684800L)
+
+static long Offset = 0;
+
+static void PutStamp(uint8_t * pBuffer)
+{
+    struct timespec now;
+    long long millis;
+    sSyncStamp stamp;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    millis = (long long)(now.tv_sec - UNIX_TIME_2000) * 1000 + now.tv_nsec / 1000000 + Offset;
+    stamp.Seconds = (uint32_t)(millis / 1000);
+    stamp.Millis = (uint16_t)(millis % 1000);
+
+    DS3231SyncFormat::PutStamp(pBuffer, stamp);
+}
+
+static speed_t Baud(long pBaud)
+{
+    switch (pBaud)
+    {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    default: return B115200;
+    }
+}
+
+static int Open(const char * pPath, bool pPty, long pBaud)
+{
+    struct termios tio;
+    int fd;
+
+    if (pPty)
+    {
+        fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if ((fd < 0) || (grantpt(fd) < 0) || (unlockpt(fd) < 0))
+        {
+            perror("posix_openpt");
+            return -1;
+        }
+        printf("%s\n", ptsname(fd));
+        fflush(stdout);
+    }
+    else
+    {
+        fd = open(pPath, O_RDWR | O_NOCTTY);
+        if (fd < 0)
+        {
+            perror(pPath);
+            return -1;
+        }
+    }
+
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, Baud(pBaud));
+        cfsetospeed(&tio, Baud(pBaud));
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    return fd;
+}
+
+int main(int argc, char * argv[])
+{
+    const char * path = NULL;
+    bool pty = false;
+    long baud = 115200;
+    uint8_t request[DS3231_SYNC_REQUEST_SIZE];
+    uint8_t reply[DS3231_SYNC_REPLY_SIZE];
+    size_t length = 0;
+    uint8_t byte;
+    int fd;
+    int option;
+
+    while ((option = getopt(argc, argv, "o:b:p")) != -1)
+    {
+        switch (option)
+        {
+        case 'o': Offset = strtol(optarg, NULL, 10); break;
+        case 'b': baud = strtol(optarg, NULL, 10); break;
+        case 'p': pty = true; break;
+        default:
+            fprintf(stderr, "Usage: %s [-o offset_ms] [-b baud] (-p | device)\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (optind < argc)
+    {
+        path = argv[optind];
+    }
+
+    if (!pty && !path)
+    {
+        fprintf(stderr, "Usage: %s [-o offset_ms] [-b baud] (-p | device)\n", argv[0]);
+        return 2;
+    }
+
+    fd = Open(path, pty, baud);
+    if (fd < 0)
+    {
+        return 1;
+    }
+
+    while (read(fd, &byte, 1) == 1)
+    {
+        // Resynchronise on the header so stray bytes (boot messages) are skipped
+        if ((length == 0) && (byte != DS3231_SYNC_HEADER_0))
+            continue;
+        if ((length == 1) && (byte != DS3231_SYNC_HEADER_1))
+        {
+            length = (byte == DS3231_SYNC_HEADER_0) ? 1 : 0;
+            continue;
+        }
+
+        request[length++] = byte;
+        if (length < DS3231_SYNC_REQUEST_SIZE)
+            continue;
+
+        length = 0;
+
+        // t2 as soon as the request is complete, t3 right before the reply goes out
+        PutStamp(&reply[2 + DS3231_SYNC_STAMP_SIZE]);
+
+        reply[0] = DS3231_SYNC_HEADER_0;
+        reply[1] = DS3231_SYNC_HEADER_1;
+        memcpy(&reply[2], &request[2], DS3231_SYNC_STAMP_SIZE);
+
+        PutStamp(&reply[2 + 2 * DS3231_SYNC_STAMP_SIZE]);
+
+        if (write(fd, reply, DS3231_SYNC_REPLY_SIZE) != DS3231_SYNC_REPLY_SIZE)
+        {
+            perror("write");
+            return 1;
+        }
+    }
+
+    close(fd);
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+DS3231TimeService.h - Shared memory time service for the DS3231 Real-Time Clock
+
+DS3231TimeServiceDaemon owns the I2C bus and publishes the RTC's time,
+temperature and status into a POSIX shared memory page. Any number of
+processes read it through DS3231TimeServiceClass without system calls or
+locks: the page is guarded by a sequence counter (seqlock), the writer makes
+it odd while updating and readers retry when they saw it odd or changed.
+
+The published time is the RTC second together with the CLOCK_MONOTONIC
+instant it started, so Now() extrapolates to nanoseconds with a vDSO
+clock_gettime() and no bus traffic.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _DS3231TimeService_h
+#define _DS3231TimeService_h
+
+#include <stdint.h>
+#include <atomic>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define DS3231_TIME_SERVICE_NAME        "/ds3231"
+#define DS3231_TIME_SERVICE_MAGIC       (0x31333244UL) // "D231"
+#define DS3231_TIME_SERVICE_VERSION     (1)
+
+struct sDS3231TimeSample
+{
+    uint32_t Seconds;       // RTC time, seconds since Jan 1st of 2000
+    int64_t Monotonic;      // CLOCK_MONOTONIC in ns when that second started
+    int16_t Temperature;    // Quarters of a degree Celsius
+    uint8_t Status;         // RTC status register, see DS3231_STATUS_*
+    uint8_t Valid;          // Zero until the daemon saw the first second boundary
+};
+
+struct sDS3231TimePage
+{
+    uint32_t Magic;
+    uint32_t Version;
+    std::atomic<uint32_t> Sequence;
+    sDS3231TimeSample Sample;
+};
+
+class DS3231TimeServiceClass
+{
+public:
+    DS3231TimeServiceClass(void) : mPage(NULL) {}
+    ~DS3231TimeServiceClass(void) { Close(); }
+
+    bool Open(const char * pName = DS3231_TIME_SERVICE_NAME)
+    {
+        int fd;
+        void * page;
+
+        Close();
+
+        fd = shm_open(pName, O_RDONLY, 0);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        page = mmap(NULL, sizeof(sDS3231TimePage), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (page == MAP_FAILED)
+        {
+            return false;
+        }
+
+        mPage = (const sDS3231TimePage *)page;
+
+        if ((mPage->Magic != DS3231_TIME_SERVICE_MAGIC) || (mPage->Version != DS3231_TIME_SERVICE_VERSION))
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void Close(void)
+    {
+        if (mPage)
+        {
+            munmap((void *)mPage, sizeof(sDS3231TimePage));
+            mPage = NULL;
+        }
+    }
+
+    // Consistent copy of the latest sample. False if the daemon has not published one yet.
+    inline bool Read(sDS3231TimeSample & pSample) const
+    {
+        uint32_t before, after;
+
+        do
+        {
+            before = mPage->Sequence.load(std::memory_order_acquire);
+            pSample = mPage->Sample;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = mPage->Sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || (before != after));
+
+        return pSample.Valid != 0;
+    }
+
+    // Current RTC time extrapolated from the last second boundary
+    inline bool Now(uint32_t & pSeconds, uint32_t & pNanoseconds) const
+    {
+        sDS3231TimeSample sample;
+        struct timespec now;
+        int64_t elapsed;
+
+        if (!Read(sample))
+        {
+            return false;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec - sample.Monotonic;
+
+        pSeconds = sample.Seconds + (uint32_t)(elapsed / 1000000000LL);
+        pNanoseconds = (uint32_t)(elapsed % 1000000000LL);
+
+        return true;
+    }
+
+private:
+    const sDS3231TimePage * mPage;
+};
+
+// Writer side, used by the daemon only
+class DS3231TimePublisherClass
+{
+public:
+    explicit DS3231TimePublisherClass(sDS3231TimePage * pPage) : mPage(pPage) {}
+
+    inline void Publish(const sDS3231TimeSample & pSample)
+    {
+        uint32_t sequence = mPage->Sequence.load(std::memory_order_relaxed);
+
+        mPage->Sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mPage->Sample = pSample;
+        mPage->Sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    sDS3231TimePage * mPage;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/*
+DS3231TimeServiceClient.cpp - Read the shared DS3231 time and measure the read cost
+
+Build: g++ -O2 -I../.. -o DS3231TimeServiceClient DS3231TimeServiceClient.cpp
+Usage: DS3231TimeServiceClient [shm name]
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+
+#include "DS3231TimeService.h"
+
+#define READS                       (10000000UL)
+
+int main(int argc, char * argv[])
+{
+    const char * name = (argc > 1) ? argv[1] : DS3231_TIME_SERVICE_NAME;
+    DS3231TimeServiceClass service;
+    sDS3231TimeSample sample;
+    struct timespec start, end;
+    uint32_t seconds, nanoseconds;
+    int temperature;
+    double elapsed;
+
+    if (!service.Open(name))
+    {
+        fprintf(stderr, "%s: time service not running\n", name);
+        return 1;
+    }
+
+    if (!service.Now(seconds, nanoseconds) || !service.Read(sample))
+    {
+        fprintf(stderr, "%s: no time published yet\n", name);
+        return 1;
+    }
+
+    temperature = (sample.Temperature < 0) ? -sample.Temperature : sample.Temperature;
+
+    printf("RTC %lu.%09lu s since 2000, %s%d.%02d C, status 0x%02x\n",
+        (unsigned long)seconds, (unsigned long)nanoseconds,
+        (sample.Temperature < 0) ? "-" : "", temperature / 4, temperature % 4 * 25,
+        sample.Status);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned long i = 0; i < READS; i++)
+    {
+        service.Read(sample);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    elapsed = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf("Read(): %.1f ns\n", elapsed / READS);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned long i = 0; i < READS; i++)
+    {
+        service.Now(seconds, nanoseconds);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    elapsed = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf("Now(): %.1f ns\n", elapsed / READS);
+
+    return 0;
+}
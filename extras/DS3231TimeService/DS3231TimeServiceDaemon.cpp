@@ -0,0 +1,156 @@
+/*
+DS3231TimeServiceDaemon.cpp - Publish the DS3231 Real-Time Clock into shared memory
+
+Reads the RTC once per second, right after its second boundary, the
+temperature once per conversion period, and publishes both through the
+seqlock page described in DS3231TimeService.h.
+
+Build: g++ -O2 -I../.. -o DS3231TimeServiceDaemon DS3231TimeServiceDaemon.cpp ../../DS3231.cpp ../../DS3231Bus.cpp ../../CalendarHelper.cpp
+Usage: DS3231TimeServiceDaemon [/dev/i2c-1] [shm name]
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the version 3 GNU General Public License as
+published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <signal.h>
+
+#include "DS3231.h"
+#include "DS3231TimeService.h"
+
+#define POLL_INTERVAL_NS            (2000000L)  // Second boundary search resolution
+#define BOUNDARY_MARGIN_NS          (20000000L) // Start searching this long before the expected boundary
+#define TEMPERATURE_INTERVAL        (64)        // s, the RTC converts every 64 seconds
+
+DS3231Class DS3231;
+
+static volatile sig_atomic_t Running = 1;
+
+static void Stop(int)
+{
+    Running = 0;
+}
+
+static int64_t Monotonic(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void SleepUntil(int64_t pMonotonic)
+{
+    struct timespec until;
+
+    until.tv_sec = pMonotonic / 1000000000LL;
+    until.tv_nsec = pMonotonic % 1000000000LL;
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) != 0 && Running)
+    {
+    }
+}
+
+// Poll the seconds register until it changes, returns the new time and when it changed
+static void WaitForSecond(sDateTime & pDateTime, int64_t & pMonotonic)
+{
+    uint8_t second;
+
+    DS3231.GetDateTime(pDateTime);
+    second = pDateTime.Second;
+
+    do
+    {
+        SleepUntil(Monotonic() + POLL_INTERVAL_NS);
+        DS3231.GetDateTime(pDateTime);
+    } while ((pDateTime.Second == second) && Running);
+
+    // The change happened somewhere in the last poll interval
+    pMonotonic = Monotonic() - POLL_INTERVAL_NS / 2;
+}
+
+int main(int argc, char * argv[])
+{
+    const char * device = (argc > 1) ? argv[1] : "/dev/i2c-1";
+    const char * name = (argc > 2) ? argv[2] : DS3231_TIME_SERVICE_NAME;
+    sDS3231TimePage * page;
+    sDS3231TimeSample sample;
+    sDateTime datetime;
+    uint32_t temperatureSeconds = 0;
+    int fd;
+
+    if (!DS3231Bus.Begin(device) || !DS3231.Begin())
+    {
+        perror(device);
+        return 1;
+    }
+
+    fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if ((fd < 0) || (ftruncate(fd, sizeof(sDS3231TimePage)) < 0))
+    {
+        perror(name);
+        return 1;
+    }
+
+    page = (sDS3231TimePage *)mmap(NULL, sizeof(sDS3231TimePage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (page == MAP_FAILED)
+    {
+        perror("mmap");
+        return 1;
+    }
+
+    page->Sequence.store(0, std::memory_order_relaxed);
+    page->Sample.Valid = 0;
+    page->Version = DS3231_TIME_SERVICE_VERSION;
+    page->Magic = DS3231_TIME_SERVICE_MAGIC;
+
+    DS3231TimePublisherClass publisher(page);
+
+    signal(SIGINT, Stop);
+    signal(SIGTERM, Stop);
+
+    sample.Temperature = DS3231.GetTemperatureRaw();
+
+    while (Running)
+    {
+        WaitForSecond(datetime, sample.Monotonic);
+        if (!Running)
+            break;
+
+        CalendarHelperClass::ConvertToSeconds(sample.Seconds, datetime);
+        sample.Status = DS3231.GetStatus();
+        sample.Valid = 1;
+
+        if (sample.Seconds - temperatureSeconds >= TEMPERATURE_INTERVAL)
+        {
+            sample.Temperature = DS3231.GetTemperatureRaw();
+            temperatureSeconds = sample.Seconds;
+        }
+
+        publisher.Publish(sample);
+
+        // Nothing changes until the next boundary, sleep through most of the second
+        SleepUntil(sample.Monotonic + 1000000000LL - BOUNDARY_MARGIN_NS);
+    }
+
+    sample.Valid = 0;
+    publisher.Publish(sample);
+
+    munmap(page, sizeof(sDS3231TimePage));
+    shm_unlink(name);
+    DS3231Bus.End();
+
+    return 0;
+}
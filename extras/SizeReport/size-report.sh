@@ -0,0 +1,90 @@
+#!/bin/sh
+#
+# size-report.sh - Compile the examples and check their footprint against budget.txt
+#
+# Usage: size-report.sh [--update] [fqbn]
+#
+# Needs arduino-cli with the core of the board installed (arduino:avr:uno
+# by default). "legacy" sketches are written for the API before DS3231Class
+# and are not built. Every example directory needs a row in budget.txt; a
+# missing row or budget fails the report unless --update records the numbers.
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+BUDGET="$HERE/budget.txt"
+UPDATE=0
+FQBN=arduino:avr:uno
+
+for arg in "$@"; do
+    case "$arg" in
+        --update) UPDATE=1 ;;
+        *) FQBN="$arg" ;;
+    esac
+done
+
+BUILD=$(mktemp -d)
+RESULT="$BUILD/budget.txt"
+ROWS="$BUILD/rows.txt"
+trap 'rm -rf "$BUILD"' EXIT
+
+failed=0
+
+# The recorded rows, then a default row for each example that has none
+grep -v '^#' "$BUDGET" | grep -v '^$' > "$ROWS" || true
+for dir in "$ROOT"/*/; do
+    sketch=$(basename "$dir")
+    if [ -f "$dir/$sketch.ino" ] && ! grep -q "^$sketch " "$ROWS"; then
+        echo "$sketch default - -" >> "$ROWS"
+    fi
+done
+
+grep '^#' "$BUDGET" > "$RESULT" || true
+
+while IFS= read -r line; do
+    set -- $line
+    sketch=$1 config=$2 flash=$3 ram=$4
+
+    if [ ! -f "$ROOT/$sketch/$sketch.ino" ]; then
+        echo "$sketch: no such example"
+        failed=1
+        continue
+    fi
+
+    case "$config" in
+        legacy)
+            printf "%-20s%-12s%-8s%s\n" "$sketch" "$config" "-" "-" >> "$RESULT"
+            printf "%-20s%-10s not built\n" "$sketch" "$config"
+            continue
+            ;;
+    esac
+
+    output=$(arduino-cli compile --fqbn "$FQBN" --library "$ROOT" \
+        --build-path "$BUILD/$sketch-$config" \
+        "$ROOT/$sketch" 2>&1) || { echo "$output"; echo "$sketch ($config): build failed"; exit 1; }
+
+    used_flash=$(echo "$output" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+    used_ram=$(echo "$output" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+
+    printf "%-20s%-12s%-8s%s\n" "$sketch" "$config" "$used_flash" "$used_ram" >> "$RESULT"
+
+    status=ok
+    if [ "$flash" = "-" ] || [ "$ram" = "-" ]; then
+        status="NO BUDGET RECORDED"
+        failed=1
+    elif [ "$used_flash" -gt "$flash" ] || [ "$used_ram" -gt "$ram" ]; then
+        status="OVER BUDGET ($flash flash, $ram ram)"
+        failed=1
+    fi
+
+    printf "%-20s%-10s flash %6s  ram %5s  %s\n" "$sketch" "$config" "$used_flash" "$used_ram" "$status"
+done < "$ROWS"
+
+if [ "$UPDATE" = 1 ]; then
+    cp "$RESULT" "$BUDGET"
+    echo "budget updated"
+    exit 0
+fi
+
+exit $failed